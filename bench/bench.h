@@ -0,0 +1,51 @@
+/**
+ * @file    bench.h
+ * @author  Mustafa Siddiqui
+ * @brief   Helpers shared by the host benchmarks: a monotonic clock and
+ *          loading input files.
+ *          => host timings only compare code paths with each other, the
+ *             PIC18 has no FPU and 16-bit ints <=
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>  // fopen(), fread(), fprintf()
+#include <stdlib.h> // realloc(), exit()
+#include <time.h>   // clock_gettime()
+
+/* seconds since an arbitrary point */
+static inline double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* append a whole file to *buf, exits if it cannot be read */
+static inline void bench_load(const char *path, char **buf, size_t *len) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        exit(1);
+    }
+    size_t n;
+    do {
+        *buf = realloc(*buf, *len + 4096);
+        if (*buf == NULL) {
+            exit(1);
+        }
+        n = fread(*buf + *len, 1, 4096, f);
+        *len += n;
+    } while (n == 4096);
+    fclose(f);
+}
+
+/* keep the optimizer from dropping a result */
+static volatile long bench_sink;
+
+#endif /* _BENCH_H_ */
@@ -0,0 +1,78 @@
+/**
+ * @file    dispatch_bench.c
+ * @author  Mustafa Siddiqui
+ * @brief   Cost per sentence type of the NMEA dispatch in nmea.c: one
+ *          sentence of each kind fed over and over through
+ *          parse_NMEA_char(), reported per sentence, per byte and
+ *          relative to a GSV that is skipped at the address field.
+ *          usage: dispatch_bench [-n passes]
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "bench.h"
+#include "../inc/nmea.h"
+//-//
+#include <string.h> // strlen()
+
+static const struct {
+    const char *name;
+    const char *body;       //between '$' and '*'
+} sentences[] = {
+    {"GSV (skipped)", "GPGSV,3,1,11,16,73,055,42,03,62,262,44,23,55,142,40,27,34,058,38"},
+    {"ZDA", "GPZDA,171204.000,15,04,2026,00,00"},
+    {"RMC", "GPRMC,171204.000,A,4308.0842,N,07737.3612,W,0.12,231.50,150426,,,A"},
+    {"GGA", "GPGGA,171204.000,4308.0842,N,07737.3612,W,1,08,1.1,153.2,M,-34.4,M,,0000"},
+};
+
+#define NUM_SENTENCES (sizeof(sentences) / sizeof(sentences[0]))
+
+int main(int argc, char **argv) {
+    int passes = 1000000;
+    double skipped = 0;
+
+    if (argc > 2 && argv[1][0] == '-' && argv[1][1] == 'n') {
+        passes = atoi(argv[2]);
+    }
+    if (passes <= 0) {
+        fprintf(stderr, "usage: %s [-n passes]\n", argv[0]);
+        return 1;
+    }
+
+    for (unsigned s = 0; s < NUM_SENTENCES; s++) {
+        char str[NMEA_MAX_LEN + 1];
+        unsigned char cs = 0;
+        for (const char *c = sentences[s].body; *c != '\0'; c++) {
+            cs ^= (unsigned char)*c;
+        }
+        snprintf(str, sizeof(str), "$%s*%02X\r\n", sentences[s].body, cs);
+        size_t len = strlen(str);
+        struct NMEA_Parser parser;
+        struct TimePos tp;
+        long fixes = 0;
+
+        init_NMEA_Parser(&parser);
+        double start = bench_now();
+        for (int p = 0; p < passes; p++) {
+            for (size_t i = 0; i < len; i++) {
+                fixes += parse_NMEA_char(&parser, str[i], &tp);
+            }
+        }
+        double ns = (bench_now() - start) * 1e9 / passes;
+        bench_sink = fixes;
+
+        //every sentence but the skipped one has to get through the checksum
+        if (s > 0 && parser.stats.rmc + parser.stats.gga + parser.stats.zda != (unsigned)passes) {
+            fprintf(stderr, "%s: checksum rejected\n", sentences[s].name);
+            return 1;
+        }
+        if (s == 0) {
+            skipped = ns;
+        }
+        printf("%-14s %3zu bytes  %6.1f ns/sentence  %5.2f ns/byte  %4.1fx\n",
+               sentences[s].name, len, ns, ns / len, ns / skipped);
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file    ephem_bench.c
+ * @author  Mustafa Siddiqui
+ * @brief   Per control cycle cost of the daily ephemeris against the
+ *          two sun position engines, and the interpolation error of
+ *          EPHEM_getAngles() against calculate_target_angles_fx()
+ *          every minute of a year at latitudes -60..60 deg.
+ *          usage: ephem_bench [-n passes]
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "bench.h"
+#include "../inc/ephem.h"
+#include "../inc/gps.h"
+//-//
+#include <math.h>   // fabs(), fmod()
+
+#define DEG_PER_BAM (360.0 / 65536)
+
+/* |a - b| of two binary angles in degrees, wrapped */
+static double bam_diff(int16_t a, int16_t b) {
+    return fabs((int16_t)(a - b) * DEG_PER_BAM);
+}
+
+/* largest error per distance of the sun from the zenith */
+struct ErrorBand {
+    double minZenith;       //sun at least this far from the zenith, deg
+    double maxZenithErr;
+    double maxAzimuthErr;
+};
+
+static void error_sweep(void) {
+    static const float lats[] = {-60.0f, -43.16f, -23.44f, 0.0f, 23.44f, 43.16f, 60.0f};
+    struct ErrorBand bands[] = {{0, 0, 0}, {5, 0, 0}, {10, 0, 0}, {20, 0, 0}};
+    const int numBands = sizeof(bands) / sizeof(bands[0]);
+
+    for (unsigned a = 0; a < sizeof(lats) / sizeof(lats[0]); a++) {
+        struct TimePos tp = {0};
+        tp.latitude = lats[a];
+        tp.longitude = -77.6f;
+        for (tp.ordinal_date = 1; tp.ordinal_date <= 365; tp.ordinal_date++) {
+            EPHEM_update(&tp);
+            for (tp.time = 0; tp.time < 1440; tp.time++) {
+                int16_t ref[2], interp[2];
+                calculate_target_angles_fx(tp, ref);
+                EPHEM_getAngles(&tp, interp);
+
+                double zenith = ref[0] * DEG_PER_BAM;
+                if (zenith >= 90.0) {
+                    continue;   //below the horizon, not tracked
+                }
+                double ez = bam_diff(interp[0], ref[0]);
+                double ea = bam_diff(interp[1], ref[1]);
+                for (int b = 0; b < numBands; b++) {
+                    if (zenith > bands[b].minZenith) {
+                        bands[b].maxZenithErr = fmax(bands[b].maxZenithErr, ez);
+                        bands[b].maxAzimuthErr = fmax(bands[b].maxAzimuthErr, ea);
+                    }
+                }
+            }
+        }
+    }
+
+    printf("interpolation error, sun above the horizon:\n");
+    for (int b = 0; b < numBands; b++) {
+        printf("  > %2.0f deg from zenith: zenith max %.2f deg, azimuth max %.2f deg\n",
+               bands[b].minZenith, bands[b].maxZenithErr, bands[b].maxAzimuthErr);
+    }
+}
+
+/* ns per call of one way to get the target angles for a fix */
+static void time_path(const char *name, int which, int passes) {
+    struct TimePos tp = {0};
+    long sum = 0;
+
+    tp.latitude = 43.16f;
+    tp.longitude = -77.6f;
+    tp.ordinal_date = 172;
+    EPHEM_update(&tp);
+
+    double start = bench_now();
+    for (int p = 0; p < passes; p++) {
+        for (tp.time = 0; tp.time < 1440; tp.time++) {
+            int16_t fx[2];
+            float fl[2];
+            if (which == 0) {
+                EPHEM_getAngles(&tp, fx);
+            } else if (which == 1) {
+                calculate_target_angles_fx(tp, fx);
+            } else {
+                calculate_target_angles(tp, fl);
+                fx[0] = (int16_t)fl[0];
+            }
+            sum += fx[0];
+        }
+    }
+    double secs = bench_now() - start;
+    bench_sink = sum;
+
+    printf("%-28s %8.1f ns/cycle\n", name, secs * 1e9 / (1440.0 * passes));
+}
+
+int main(int argc, char **argv) {
+    int passes = 200;
+
+    if (argc > 2 && argv[1][0] == '-' && argv[1][1] == 'n') {
+        passes = atoi(argv[2]);
+    }
+    if (passes <= 0) {
+        fprintf(stderr, "usage: %s [-n passes]\n", argv[0]);
+        return 1;
+    }
+
+    printf("per control cycle, %d x 1440 minutes:\n", passes);
+    time_path("EPHEM_getAngles()", 0, passes);
+    time_path("calculate_target_angles_fx()", 1, passes);
+    time_path("calculate_target_angles()", 2, passes);
+    error_sweep();
+    return 0;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file    fixmath_bench.c
+ * @author  Mustafa Siddiqui
+ * @brief   Cost of the fixed-point kernels in fixmath.c against the
+ *          float libm calls they replace, over the same random inputs.
+ *          => on the host the float calls run on an FPU; on the PIC18
+ *             each is a software-float routine, so this ratio is the
+ *             worst case for the fixed-point side <=
+ *          usage: fixmath_bench [-n calls]
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "bench.h"
+#include "../inc/fixmath.h"
+//-//
+#include <math.h>   // sinf(), atan2f(), sqrtf(), acosf()
+
+#define NUM_INPUTS  4096
+
+static int16_t in_x[NUM_INPUTS];
+static int16_t in_y[NUM_INPUTS];
+static int16_t in_z[NUM_INPUTS];
+
+/* ns per call of each kernel, fixed point then float */
+static double run(int which, long calls) {
+    long sum = 0;
+    float fsum = 0;
+
+    double start = bench_now();
+    for (long n = 0; n < calls; n++) {
+        int i = n & (NUM_INPUTS - 1);
+        switch (which) {
+            case 0: sum += FX_sin((uint16_t)in_x[i]); break;
+            case 1: fsum += sinf(in_x[i] * (3.14159265f / 32768)); break;
+            case 2: sum += FX_atan2(in_y[i], in_x[i]); break;
+            case 3: fsum += atan2f(in_y[i], in_x[i]); break;
+            case 4: sum += FX_magnitude(in_x[i], in_y[i], in_z[i]); break;
+            case 5: fsum += sqrtf((float)in_x[i] * in_x[i] + (float)in_y[i] * in_y[i]
+                                  + (float)in_z[i] * in_z[i]); break;
+            case 6: sum += FX_acos(in_x[i]); break;
+            default: fsum += acosf(in_x[i] / 32767.0f); break;
+        }
+    }
+    double secs = bench_now() - start;
+    bench_sink = sum + (long)fsum;
+    return secs * 1e9 / calls;
+}
+
+int main(int argc, char **argv) {
+    static const char *names[] = {"sin", "atan2", "magnitude", "acos"};
+    long calls = 20000000;
+    uint32_t seed = 12345;
+
+    if (argc > 2 && argv[1][0] == '-' && argv[1][1] == 'n') {
+        calls = atol(argv[2]);
+    }
+    if (calls <= 0) {
+        fprintf(stderr, "usage: %s [-n calls]\n", argv[0]);
+        return 1;
+    }
+    for (int i = 0; i < NUM_INPUTS; i++) {
+        seed = seed * 1103515245UL + 12345UL;
+        in_x[i] = (int16_t)(seed >> 16);
+        seed = seed * 1103515245UL + 12345UL;
+        in_y[i] = (int16_t)(seed >> 16);
+        seed = seed * 1103515245UL + 12345UL;
+        in_z[i] = (int16_t)(seed >> 16);
+    }
+
+    printf("%-10s %10s %10s\n", "", "fixed", "float");
+    for (int k = 0; k < 4; k++) {
+        double fx = run(2 * k, calls);
+        double fl = run(2 * k + 1, calls);
+        printf("%-10s %7.2f ns %7.2f ns\n", names[k], fx, fl);
+    }
+    return 0;
+}
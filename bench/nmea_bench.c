@@ -0,0 +1,99 @@
+/**
+ * @file    nmea_bench.c
+ * @author  Mustafa Siddiqui
+ * @brief   Throughput of the NMEA parser on the host. The files given
+ *          on the command line (fuzz/corpus/ by default, see
+ *          CMakeLists.txt) are fed byte by byte through
+ *          parse_NMEA_char() directly and through poll_time_pos() from
+ *          the stub UART, as gps.c does on the target, and through the
+ *          original strncat()/strtok() path in nmea_legacy.c.
+ *          => the old path only took $GPRMC with a lower case
+ *             checksum, so it returns fewer fixes on the same input <=
+ *          usage: nmea_bench [-n passes] file...
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "bench.h"
+#include "../inc/gps.h"
+#include "../test/stub/uart_stub.h"
+#include "nmea_legacy.h"
+
+/* whole input through parse_NMEA_char() => fixes returned */
+static long run_parser(const char *buf, size_t len) {
+    struct NMEA_Parser parser;
+    struct TimePos tp;
+    long fixes = 0;
+
+    init_NMEA_Parser(&parser);
+    for (size_t i = 0; i < len; i++) {
+        fixes += parse_NMEA_char(&parser, buf[i], &tp);
+    }
+    return fixes;
+}
+
+/* whole input through the UART path of gps.c => fixes returned */
+static long run_gps(const char *buf, size_t len) {
+    struct TimePos tp;
+    long fixes = 0;
+
+    UART_stub_feed(buf, len);
+    while (UART_stub_pending()) {
+        fixes += poll_time_pos(&tp);
+    }
+    return fixes;
+}
+
+/* whole input through the old strtok() path => fixes returned */
+static long run_legacy(const char *buf, size_t len) {
+    struct TimePos tp;
+    return legacy_feed(buf, len, &tp);
+}
+
+static void report(const char *name, long (*run)(const char *, size_t),
+                   const char *buf, size_t len, long sentences, int passes) {
+    long fixes = 0;
+    double start = bench_now();
+    for (int p = 0; p < passes; p++) {
+        fixes += run(buf, len);
+    }
+    double secs = bench_now() - start;
+    bench_sink = fixes;
+
+    printf("%-16s %9.0f sentences/s  %6.2f ns/byte  %ld fixes/pass\n", name,
+           sentences * passes / secs, secs * 1e9 / ((double)len * passes),
+           fixes / passes);
+}
+
+int main(int argc, char **argv) {
+    int passes = 20000;
+    char *buf = NULL;
+    size_t len = 0;
+    long sentences = 0;
+    int i = 1;
+
+    if (argc > 2 && argv[1][0] == '-' && argv[1][1] == 'n') {
+        passes = atoi(argv[2]);
+        i = 3;
+    }
+    if (i >= argc || passes <= 0) {
+        fprintf(stderr, "usage: %s [-n passes] file...\n", argv[0]);
+        return 1;
+    }
+    for (; i < argc; i++) {
+        bench_load(argv[i], &buf, &len);
+    }
+    for (size_t k = 0; k < len; k++) {
+        sentences += (buf[k] == '$');
+    }
+
+    printf("%zu bytes, %ld sentences, %d passes\n", len, sentences, passes);
+    report("parse_NMEA_char", run_parser, buf, len, sentences, passes);
+    report("poll_time_pos", run_gps, buf, len, sentences, passes);
+    report("legacy strtok", run_legacy, buf, len, sentences, passes);
+
+    free(buf);
+    return 0;
+}
@@ -0,0 +1,213 @@
+/**
+ * @file    nmea_legacy.c
+ * @author  Carter Bordeleau, Mustafa Siddiqui
+ * @brief   The GPRMC path of the original gps.c, kept only as the
+ *          baseline for nmea_bench: strncat() per received byte, two
+ *          100-byte copies and two strtok() passes per sentence.
+ *          Copied as it was except where it would crash on the corpus:
+ *            - a sentence that would overrun UART_buffer is dropped
+ *            - old_is_Valid_GPRMC() frees its malloc'd buffer instead of a
+ *              strtok token (the malloc and free are kept for timing)
+ *            - functions are prefixed old_ to link next to nmea.c
+ *            - the checksum is masked to 8 bits before sprintf("%x") so a
+ *              byte above 0x7F cannot overflow check_valid[]
+ * @date    04/20/2022
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "nmea_legacy.h"
+//-//
+#include <stdio.h>  // sprintf()
+#include <stdlib.h> // atof(), malloc(), free()
+#include <string.h> // strncat(), strtok(), memcpy()
+
+static char UART_buffer[100];
+
+static int old_str_to_minute(char* str) {
+    return 600* (str[0] - '0') + 60* (str[1] - '0') + 10* (str[2] - '0') + (str[3] - '0');
+}
+
+static float old_str_to_latitude(char* str) {
+    return (float)(atof(str) / 100);
+}
+
+static float old_str_to_longitude(char* str) {
+    return (float)(atof(str) / 100);
+}
+
+static int old_str_to_ordinal_date(char* str) {
+    int DD = 10*(str[0] - '0') + (str[1] - '0');
+    int MM = 10*(str[2] - '0') + (str[3] - '0');
+    int YY = 10*(str[4] - '0') + (str[5] - '0');
+    
+    int days_in_feb = 28;
+    int doy = DD;
+
+    if( (YY % 4 == 0 && YY % 100 != 0 ) || (YY % 400 == 0) )
+    {
+        days_in_feb = 29;
+    }
+
+    switch(MM)
+    {
+        case 2: doy += 31; break;
+        case 3: doy += 31+days_in_feb; break;
+        case 4: doy += 62+days_in_feb; break;
+        case 5: doy += 92+days_in_feb; break;
+        case 6: doy += 123+days_in_feb; break;
+        case 7: doy += 153+days_in_feb; break;
+        case 8: doy += 184+days_in_feb; break;
+        case 9: doy += 215+days_in_feb; break;
+        case 10: doy += 245+days_in_feb; break;
+        case 11: doy += 276+days_in_feb; break;
+        case 12: doy += 306+days_in_feb; break;
+    }
+
+    return doy;
+}
+
+static struct TimePos old_parse_GPRMC(const char* input_str) {
+    struct TimePos timePosobj;
+    char str[100];
+    memcpy(str, input_str, 100);
+
+    const char delimiter[2] = ",";
+    char * token;
+    int i = 1;
+    
+    token = strtok(str, delimiter);
+    while( token != NULL ) {
+        i = i+1;
+        token = strtok(NULL, delimiter);
+        
+        if (i == 2) {
+            timePosobj.time = old_str_to_minute(token);
+        } else if(i==4) {
+            timePosobj.latitude = old_str_to_latitude(token);
+        } else if(i==5) {
+            if ( (token[0] == 'S') || (token[0] == 's')){
+                timePosobj.latitude = -timePosobj.latitude;
+            }
+        } else if(i==6) {
+            timePosobj.longitude = old_str_to_longitude(token);
+        } else if(i==7) {
+            if ( (token[0] == 'W') || (token[0] == 'w')){
+                timePosobj.longitude = -timePosobj.longitude;
+            }
+        } else if(i==10) {
+            timePosobj.ordinal_date = old_str_to_ordinal_date(token);
+        }
+    }
+    return timePosobj;
+}
+
+static int old_is_GPRMC(char* str){
+    char newStr[7];
+    newStr[6] = '\0';
+    memcpy(newStr, str, 6);
+    return !strcmp(newStr, "$GPRMC");
+}
+
+static int old_calc_NMEA_Checksum( char *buf, int cnt )
+{
+    char Character;
+    int Checksum = 0;
+    int i;
+
+    for (i=0;i<cnt;++i)
+    {
+        Character = buf[i];
+        switch(Character)
+        {
+            case '$':
+                break;
+            case '*':
+                i = cnt;
+                continue;
+            default:
+                if (Checksum == 0)
+                {
+                    Checksum = Character;
+                }
+                else
+                {
+                    Checksum = Checksum ^ Character;
+                }
+                break;
+        }
+    }
+    return (Checksum);
+}
+
+static int old_is_Valid_GPRMC(char* str){
+    char newStr[100];
+    memcpy(newStr, str, 100);
+
+    int correct_checksum = old_calc_NMEA_Checksum(str, (int)strlen(str));
+   
+    const char delimiter[2] = ",";
+    char * token;
+    int i = 1;
+    char * buffer = malloc(sizeof(char)*5);
+    char * check_str = buffer;
+    int valid = 1;
+
+    token = strtok(newStr, delimiter);
+    while( token != NULL ) {
+        i = i+1;
+        token = strtok(NULL, delimiter);
+        if (i ==13) { 
+            check_str = token;
+        } 
+    }
+    
+    if (i != 14 || check_str[1] != '*' || check_str[0] == 'N') {
+        valid = 0;
+    } else {
+        char check_valid[3];
+        sprintf(check_valid, "%x", correct_checksum & 0xFF);
+        char* checksum_str = &check_str[2];
+        if ((check_valid[0]!=checksum_str[0] || check_valid[1]!=checksum_str[1])){
+            valid = 0;
+        }
+    }
+
+    free(buffer);
+    return valid;
+}
+
+/* the receive loop of the old get_target_angles() over a buffer */
+long legacy_feed(const char *buf, size_t len, struct TimePos *tp) {
+    long fixes = 0;
+    size_t n = 0;       // chars in UART_buffer, 0 = waiting for '$'
+    char data;
+
+    for (size_t k = 0; k < len; k++) {
+        data = buf[k];
+        if (n == 0 && data != '$') {
+            continue;
+        }
+        if (n == sizeof(UART_buffer) - 1) {
+            memset(UART_buffer, 0, sizeof(UART_buffer));
+            n = 0;
+            continue;
+        }
+        strncat(UART_buffer, &data, 1);
+        n++;
+        if (data != '\r') {
+            continue;
+        }
+
+        if (old_is_GPRMC(UART_buffer) && old_is_Valid_GPRMC(UART_buffer)) {
+            char newStr[100];
+            memcpy(newStr, UART_buffer, 100);
+            *tp = old_parse_GPRMC(newStr);
+            fixes++;
+        }
+        memset(UART_buffer, 0, sizeof(UART_buffer));
+        n = 0;
+    }
+    return fixes;
+}
@@ -0,0 +1,28 @@
+/**
+ * @file    nmea_legacy.h
+ * @author  Mustafa Siddiqui
+ * @brief   The original strtok based GPRMC path, benchmark baseline only.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _NMEA_LEGACY_H_
+#define _NMEA_LEGACY_H_
+
+#include "../inc/nmea.h"    // struct TimePos
+#include <stddef.h>         // size_t
+
+/**
+ * @brief   Run received bytes through the old receive loop, strncat()
+ *          per byte and is_GPRMC()/is_Valid_GPRMC()/parse_GPRMC() on
+ *          each '\r' terminated sentence.
+ * @param   buf: received bytes
+ * @param   len: number of bytes
+ * @param   tp: last decoded fix
+ * @return  number of sentences that passed is_Valid_GPRMC()
+ */
+long legacy_feed(const char *buf, size_t len, struct TimePos *tp);
+
+#endif /* _NMEA_LEGACY_H_ */
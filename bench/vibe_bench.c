@@ -0,0 +1,93 @@
+/**
+ * @file    vibe_bench.c
+ * @author  Mustafa Siddiqui
+ * @brief   Per block cost of the vibration monitor in vibe.c on
+ *          synthetic 100 Hz accelerometer data, and what it makes of
+ *          each case: still, resonance at two amplitudes, and a strong
+ *          vibration away from the resonance.
+ *          usage: vibe_bench [-n blocks]
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "bench.h"
+#include "../inc/vibe.h"
+//-//
+#include <math.h>   // sin()
+
+#define ODR_HZ      100.0
+#define LSB_PER_G   8192.0  // +-4 g left justified
+#define PI          3.14159265358979
+
+static const struct {
+    const char *name;
+    double hz;          // vibration on z
+    double g;           // its amplitude
+    int windy;          // expected verdict
+} cases[] = {
+    {"still", 0, 0, 0},
+    {"3 Hz 0.04 g", 3, 0.04, 1},
+    {"3 Hz 0.02 g", 3, 0.02, 0},
+    {"10 Hz 0.12 g", 10, 0.12, 1},
+};
+
+#define NUM_CASES (sizeof(cases) / sizeof(cases[0]))
+
+/* deterministic noise, about +-3 mg */
+static double noise(void) {
+    static uint32_t seed = 12345;
+    seed = seed * 1103515245UL + 12345UL;
+    return ((int)(seed >> 16 & 0xFFFF) - 32768) / 32768.0 * 0.003;
+}
+
+int main(int argc, char **argv) {
+    long blocks = 20000;
+    int wrong = 0;
+
+    if (argc > 2 && argv[1][0] == '-' && argv[1][1] == 'n') {
+        blocks = atol(argv[2]);
+    }
+    if (blocks < VIBE_TRIP_BLOCKS + 2) {
+        fprintf(stderr, "usage: %s [-n blocks], at least %d\n", argv[0], VIBE_TRIP_BLOCKS + 2);
+        return 1;
+    }
+
+    for (unsigned k = 0; k < NUM_CASES; k++) {
+        long n = blocks * VIBE_N;
+        int16_t *samples = malloc(sizeof(int16_t) * 3 * VIBE_N * 16);
+        if (samples == NULL) {
+            return 1;
+        }
+
+        // 16 blocks of input, replayed => the timing is VIBE_push() only
+        for (int i = 0; i < VIBE_N * 16; i++) {
+            double t = i / ODR_HZ;
+            double z = 1.0 + cases[k].g * sin(2 * PI * cases[k].hz * t);
+            samples[3 * i + 0] = (int16_t)lround(noise() * LSB_PER_G);
+            samples[3 * i + 1] = (int16_t)lround(noise() * LSB_PER_G);
+            samples[3 * i + 2] = (int16_t)lround((z + noise()) * LSB_PER_G);
+        }
+
+        initVibe();
+        double start = bench_now();
+        for (long i = 0; i < n; i++) {
+            VIBE_push(&samples[3 * (i % (VIBE_N * 16))]);
+        }
+        double secs = bench_now() - start;
+
+        struct VIBE_Stats stats;
+        VIBE_getStats(&stats);
+        wrong += (stats.windy != cases[k].windy);
+        printf("%-13s %6.1f ns/sample %7.1f ns/block  rms %3u  amp %u/%u/%u  %s\n",
+               cases[k].name, secs * 1e9 / n, secs * 1e9 / blocks, stats.rms,
+               stats.amp[0], stats.amp[1], stats.amp[2], stats.windy ? "windy" : "calm");
+        free(samples);
+    }
+
+    if (wrong) {
+        printf("%d case(s) classified wrong\n", wrong);
+    }
+    return wrong != 0;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file    nmea_fuzz.c
+ * @author  Mustafa Siddiqui
+ * @brief   Fuzz harness for the NMEA parser in nmea.c. Each input is fed
+ *          byte by byte to parse_NMEA_char(), as the UART would, and
+ *          as one string to the whole sentence helpers.
+ *          => libFuzzer: build with -DNMEA_LIBFUZZER=ON (clang) <=
+ *          => AFL/replay: the main() below reads each file argument,
+ *             or stdin if there is none <=
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "../inc/nmea.h"
+//-//
+#include <stdint.h> // uint8_t
+#include <stdio.h>  // fopen(), fread(), fprintf()
+#include <stdlib.h> // abort(), malloc()
+#include <string.h> // memcpy()
+
+/* a finding => libFuzzer and AFL both treat abort() as a crash */
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            abort(); \
+        } \
+    } while (0)
+
+/* anything handed out as a fix has to be in range */
+static void check_time_pos(const struct TimePos *tp) {
+    CHECK(tp->time >= 0 && tp->time < 1440);
+    CHECK(tp->second < 60);
+    CHECK(tp->ordinal_date >= 1 && tp->ordinal_date <= 366);
+    CHECK(tp->year < 100);
+    CHECK(tp->latitude >= -90.0f && tp->latitude <= 90.0f);
+    CHECK(tp->longitude >= -180.0f && tp->longitude <= 180.0f);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    struct NMEA_Parser parser;
+    struct TimePos tp;
+
+    // the UART path
+    init_NMEA_Parser(&parser);
+    for (size_t i = 0; i < size; i++) {
+        if (parse_NMEA_char(&parser, (char)data[i], &tp)) {
+            check_time_pos(&tp);
+            CHECK(NMEA_fix_usable(&parser.fix));
+        }
+        CHECK(parser.len <= NMEA_FIELD_LEN);
+    }
+    CHECK(parser.stats.bytes == size);
+
+    // the whole sentence helpers want a terminated string
+    char *str = malloc(size + 1);
+    if (str == NULL) {
+        return 0;
+    }
+    memcpy(str, data, size);
+    str[size] = '\0';
+
+    if (is_Valid_GPRMC(str)) {
+        tp = parse_GPRMC(str);
+        check_time_pos(&tp);
+    }
+    calc_NMEA_Checksum(str, (int)size);
+    if (size >= 6) {
+        int doy = str_to_ordinal_date(str);
+        CHECK(doy >= 0 && doy <= 366);
+    }
+
+    free(str);
+    return 0;
+}
+
+#ifndef NMEA_LIBFUZZER
+/* run one input file through the harness */
+static int run_file(FILE *f) {
+    static uint8_t buf[1 << 16];
+    size_t size = fread(buf, 1, sizeof(buf), f);
+    return LLVMFuzzerTestOneInput(buf, size);
+}
+
+/* replay the given files, or stdin for AFL */
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        return run_file(stdin);
+    }
+    for (int i = 1; i < argc; i++) {
+        FILE *f = fopen(argv[i], "rb");
+        if (f == NULL) {
+            fprintf(stderr, "%s: cannot open\n", argv[i]);
+            return 1;
+        }
+        run_file(f);
+        fclose(f);
+    }
+    printf("%d inputs ok\n", argc - 1);
+    return 0;
+}
+#endif /* NMEA_LIBFUZZER */
@@ -17,6 +17,8 @@
 #define _ACCEL_H_
 
 #include <stdint.h> // uint8_t, int16_t
+#include "sample.h" // struct SensorSample
+#include "filter.h" // FILTER_MEDIAN_LEN
 
 /* Register Maps */
 #define _ADDR_DEVID       0x00  /* device ID => stores fixed value of 0xE5 */
@@ -25,6 +27,9 @@
 #define _ADDR_OFSZ        0x20  /* z-axis offset */
 #define _ADDR_BW_RATE     0x2C  /* data rate and power mode control */
 #define _ADDR_POWER_CTL   0x2D  /* power-saving features control */
+#define _ADDR_INT_ENABLE  0x2E  /* interrupt enable control */
+#define _ADDR_INT_MAP     0x2F  /* interrupt mapping control => 0 = INT1 */
+#define _ADDR_INT_SOURCE  0x30  /* source of interrupts */
 #define _ADDR_DATA_FORMAT 0x31  /* data format control */
 #define _ADDR_DATA_X0     0x32  /* x-axis data 0 */
 #define _ADDR_DATA_X1     0x33  /* x-axis data 1 */
@@ -32,38 +37,46 @@
 #define _ADDR_DATA_Y1     0x35  /* y-axis data 1 */
 #define _ADDR_DATA_Z0     0x36  /* z-axis data 0 */
 #define _ADDR_DATA_Z1     0x37  /* z-axis data 1 */
+#define _ADDR_FIFO_CTL    0x38  /* FIFO control */
+#define _ADDR_FIFO_STATUS 0x39  /* FIFO status => entries in bits 5:0 */
 
 /* Constant value stored in DEVID register of accelerometer */
 #define DEVID   (0xE5)
 
-/* Utility Macros to set/clear individual bits in a register */
-#define SET(reg, bitNum)   (reg |= (1 << bitNum))
-#define CLEAR(reg, bitNum) (reg &= ~(1 << bitNum))
-
 /* Utility macro to square a value */
 #define SQUARE(num) (num * num)
 
-/* Number of axis readings given by the sensor */
-#define NUM_AXIS        3
-
 /* Number of readings to average when reading sensor data */
 /* 0.1 sec worth of data given a 100 Hz data rate */
-#define NUM_READINGS    10
+#define ACCEL_NUM_READINGS      10
 
-/* offset values to write to offset registers */
-int16_t xAxisOffset = -192;
-int16_t yAxisOffset = -192;
-int16_t zAxisOffset = 320;
+/* FIFO in stream mode (keeps the newest 32 samples), watermark on INT1 */
+/* => INT1 goes high once 5 new samples are waiting, a block per 50 ms */
+#define ACCEL_FIFO_STREAM       0x80
+#define ACCEL_FIFO_WATERMARK    5
+#define ACCEL_FIFO_ENTRIES      0x3F    /* mask for FIFO_STATUS */
+#define ACCEL_INT_WATERMARK     0x02    /* INT_ENABLE/INT_MAP/INT_SOURCE bit */
 
-/**
- * @brief   Create first data byte that is transmitted over SPI for
- *          accelerometer. byte => [R/W, MB, A5-A0]
- * @param   RW: 1 or 0 => read (1)/write (0) bit 
- * @param   MB: 1 or 0 => multiple byte transmission bit
- * @param   addr: address of register to access 
- * @return  content of the data byte to tranmsit
- */
-unsigned char _ACCEL_createDataByte1(int RW, int MB, unsigned char addr);
+/* Blocks (medians of 3) in the moving average behind ACCEL_getFiltered() */
+/* => the filtered state depends on the last ACCEL_FILTER_SPAN blocks */
+#define ACCEL_FILTER_LEN        4
+#define ACCEL_FILTER_SPAN       (FILTER_MEDIAN_LEN - 1 + ACCEL_FILTER_LEN)
+
+/* Settled => the last ACCEL_SETTLE_LEN blocks, i.e. every block behind */
+/* the filtered state (0.3 sec), vary less than ACCEL_SETTLE_VAR */
+/* => sum of the x,y,z variances in counts^2, 1 g = 8192 counts: */
+/*    2000 ~ 0.3 deg rms of swing, a still sensor shows a few hundred */
+#define ACCEL_SETTLE_LEN        ACCEL_FILTER_SPAN
+#define ACCEL_SETTLE_VAR        2000UL
+
+/* Longest wait for the structure to settle => then measure anyway */
+#define ACCEL_SETTLE_TIMEOUT_MS 3000
+
+/* ADXL343 INT1 => RB1/INT1 */
+#define ACCEL_INT1_PIN          TRISBbits.TRISB1
+
+/* Longest wait for a watermark, 6 blocks => then read what is there */
+#define ACCEL_FIFO_TIMEOUT_MS   300
 
 /**
  * @brief   Write to a specified register on the accelerometer over SPI.
@@ -80,6 +93,19 @@ signed char _ACCEL_writeToRegister(unsigned char addr, unsigned char data);
  */
 unsigned char _ACCEL_readFromRegister(unsigned char addr);
 
+/**
+ * @brief   Read consecutive registers on the accelerometer in a single
+ *          ~CS low transaction using the multi-byte (MB) bit.
+ *          => DATAX0..DATAZ1 take 7 bytes this way instead of 12 as
+ *             six single reads, at 125 kHz SCK ~0.45 ms vs ~0.8 ms
+ *             of bus time per sample <=
+ * @param   addr: address of the first register to read
+ * @param   data: buffer of at least len bytes
+ * @param   len: number of registers to read
+ * @return  NULL
+ */
+void _ACCEL_readRegisters(unsigned char addr, uint8_t *data, unsigned char len);
+
 /**
  * @brief   Get the device ID of the accelerometer sensor.
  *          Should receive a fixed value of 0xE5 or 229
@@ -90,7 +116,7 @@ unsigned char _ACCEL_getDeviceID(void);
 
 /**
  * @brief   Get current x, y, and z axis readings from the
- *          accelerometer.
+ *          accelerometer with one burst read of the data registers.
  *          =>  pass by reference is used to prevent memory leaks
  *              with issues stemming from allocating memory for 
  *              pointers inside functions and returning those pointers
@@ -101,28 +127,101 @@ unsigned char _ACCEL_getDeviceID(void);
 void _ACCEL_getCurrentReading(int16_t *sensorData);
 
 /**
- * @brief   Get data equivalent to average of NUM_READINGS.
+ * @brief   Pop every sample waiting in the FIFO, each with one burst
+ *          read of the data registers, and average them.
+ *          => GIEL must be 0 for the whole call: it runs in ACCEL_ISR()
+ *             and must not be re-entered from there <=
+ * @param   avgData: pointer to an integer array to hold [x,y,z] values
+ * @return  number of samples averaged, 0 if the FIFO was empty
+ */
+unsigned char _ACCEL_drainFIFO(int16_t *avgData);
+
+/**
+ * @brief   Get data equivalent to average of ACCEL_FIFO_WATERMARK (or more)
+ *          independent samples: waits for a block that the FIFO
+ *          watermark interrupt has captured since the last call. If
+ *          the FIFO had already passed the watermark the block holds
+ *          up to 33 samples, i.e. the last 0.33 sec at 100 Hz.
+ *          => no SPI traffic while waiting <=
  * @param   avgData: pointer to a 32-bit integer array to hold [x,y,z] values
  * @return  NULL
  */
 void _ACCEL_getAvgReading(int32_t *avgData);
 
+/**
+ * @brief   Copy the block last captured by ACCEL_ISR().
+ * @param   sample: in => sample last used (seq 0 if none),
+ *                  out => latest sample if there is a newer one
+ * @return  1 if *sample was updated with a fresh block, 0 if not
+ */
+int ACCEL_getSample(struct SensorSample *sample);
+
+/**
+ * @brief   Copy the filtered state: per axis, the median of the last 3
+ *          blocks averaged over the last ACCEL_FILTER_LEN medians.
+ *          Updated with every block, so it never waits.
+ * @param   sample: filled with the filtered state, count = medians
+ *          in the average, seq/ticks of the newest block
+ * @return  1 if at least one block has been filtered, 0 if not
+ */
+int ACCEL_getFiltered(struct SensorSample *sample);
+
+/**
+ * @brief   How much the structure is moving: sum of the x,y,z variances
+ *          of the last ACCEL_SETTLE_LEN blocks. Updated with every block.
+ * @param   NULL
+ * @return  variance in counts^2, UINT32_MAX until the window has filled
+ */
+uint32_t ACCEL_getMotion(void);
+
+/**
+ * @brief   Wait until the structure has stopped moving: ACCEL_SETTLE_LEN
+ *          blocks have come in since the call and they vary less than
+ *          ACCEL_SETTLE_VAR. The filtered state then only holds samples
+ *          taken at rest. Replaces a fixed delay after a motor move.
+ *          => at least 0.3 sec, at most ACCEL_SETTLE_TIMEOUT_MS <=
+ * @param   idle: NULL or called about once a ms while waiting, for
+ *          work that can't wait that long (draining the UART RX ring)
+ * @return  milliseconds waited, -1 if it timed out still moving
+ */
+int ACCEL_waitSettled(void (*idle)(void));
+
+/**
+ * @brief   INT1 handler: the FIFO reached its watermark, so drain and
+ *          average it into the sample slot with a Timer1 timestamp
+ *          and the next sequence number, then feed the block to the
+ *          streaming filters. Runs at low priority so UART and clock
+ *          interrupts can cut in. Called from the ISR.
+ * @param   NULL
+ * @return  NULL
+ */
+void ACCEL_ISR(void);
+
 /**
  * @brief   Configure accelerometer's SPI module as slave
  *          in line with PIC18's configurations as master.
  *          Enables sensor measurements to be transmitted 
- *          from the accelerometer.
+ *          from the accelerometer, buffered in its FIFO with
+ *          a watermark interrupt on INT1 (RB1).
  * @param   NULL
  * @return  1 if successfully initialized, 0 if not
  */
 int initAccel(void);
 
 /**
- * @brief   Get current zenith angle by calculating it from
- *          x, y, and z axis accelerometer readings.
+ * @brief   Get current zenith angle by calculating it from the
+ *          filtered x, y, and z axis accelerometer readings.
+ *          => only waits if no block has come in yet <=
  * @param   NULL
  * @return  Integer value for the Zenith angle
  */
 int getCurrentZenith(void);
 
+/**
+ * @brief   Zenith angle of a gravity vector, as getCurrentZenith().
+ * @param   sensorData: [x, y, z] accelerometer reading
+ * @return  Integer value for the Zenith angle
+ */
+int ACCEL_Zenith(const int16_t *sensorData);
+
 #endif /* _ACCEL_H_ */
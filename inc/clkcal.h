@@ -0,0 +1,81 @@
+/**
+ * @file    clkcal.h
+ * @author  Mustafa Siddiqui
+ * @brief   Header file for calibrating the internal RC oscillator
+ *          against the EM506's 1PPS output.
+ *          => PPS goes to RB0/INT0. Each rising edge is timestamped with
+ *             the Timer1 tick count (see rtc.h), the ticks per PPS are
+ *             averaged over CLKCAL_AVG_EDGES edges and OSCTUNE is
+ *             stepped until the error is within half a tuning step <=
+ *          => CCP1/ECCP1 are busy generating PWM, so INT0 + Timer1 is
+ *             used in place of a hardware capture <=
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _CLKCAL_H_
+#define _CLKCAL_H_
+
+#include <stdint.h> // int32_t, uint32_t
+
+/* PPS input pin */
+#define CLKCAL_PPS_PIN          TRISBbits.TRISB0
+
+/* Number of PPS periods averaged per measurement */
+#define CLKCAL_AVG_EDGES        8
+
+/* PPS periods further than this from nominal are glitches or lost */
+/* pulses => 30000 ppm covers the oscillator's untrimmed tolerance */
+#define CLKCAL_MAX_ERROR_PPM    30000L
+
+/* OSCTUNE step size assumed until one has been measured */
+#define CLKCAL_DEFAULT_STEP_PPM 4000L
+
+/**
+ * @brief   Configure RB0/INT0 as a rising edge interrupt for the PPS.
+ * @param   NULL
+ * @return  NULL
+ */
+void initClockCal(void);
+
+/**
+ * @brief   Run one step of the OSCTUNE control loop if a new averaged
+ *          measurement is available. Call regularly from the main loop.
+ * @param   NULL
+ * @return  1 if OSCTUNE was changed, 0 if not
+ */
+int CLKCAL_service(void);
+
+/**
+ * @brief   Oscillator error from the last averaged measurement.
+ * @param   NULL
+ * @return  parts per million, positive = running fast
+ */
+int32_t CLKCAL_getErrorPpm(void);
+
+/**
+ * @brief   Instruction cycles (Fosc/4) counted per PPS period in the
+ *          last averaged measurement => 2000000 with a perfect clock.
+ * @param   NULL
+ * @return  cycles per second, 0 if no measurement yet
+ */
+uint32_t CLKCAL_getCyclesPerPps(void);
+
+/**
+ * @brief   Whether the oscillator is within half a tuning step of
+ *          nominal according to the last measurement.
+ * @param   NULL
+ * @return  1 if locked, 0 if not
+ */
+int CLKCAL_isLocked(void);
+
+/**
+ * @brief   INT0 handler, must be called from the interrupt routine.
+ * @param   NULL
+ * @return  NULL
+ */
+void CLKCAL_ISR(void);
+
+#endif /* _CLKCAL_H_ */
@@ -0,0 +1,74 @@
+/**
+ * @file    eeprom.h
+ * @author  Mustafa Siddiqui
+ * @brief   Header file for reading/writing the PIC18F4680's 1024 byte
+ *          data EEPROM, and the map of what is stored where.
+ *          => each write takes ~4 ms and a cell survives ~1M writes, so
+ *             only persist data that changes at most a few times a day <=
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _EEPROM_H_
+#define _EEPROM_H_
+
+/* Size of data EEPROM in bytes */
+#define EEPROM_SIZE         1024
+
+/* EEPROM map => keep regions in address order and non-overlapping */
+#define EE_ADDR_EPHEM       0x000   /* daily solar ephemeris, see ephem.h */
+#define EE_SIZE_EPHEM       400
+#define EE_ADDR_GPSAID      0x190   /* last GPS fix, see gpsaid.h */
+#define EE_SIZE_GPSAID      16
+#define EE_ADDR_SENSORCFG   0x1A0   /* sensor calibration profile, see sensorcfg.h */
+#define EE_SIZE_SENSORCFG   16
+#define EE_ADDR_MAGCAL      0x1B0   /* magnetometer soft-iron matrix, see magcal.h */
+#define EE_SIZE_MAGCAL      16
+
+/**
+ * @brief   Read one byte from data EEPROM.
+ * @param   addr: address in [0, EEPROM_SIZE)
+ * @return  byte stored at addr
+ */
+unsigned char EEPROM_readByte(unsigned int addr);
+
+/**
+ * @brief   Write one byte to data EEPROM and wait for the write
+ *          to finish. Interrupts are held off only for the unlock
+ *          sequence.
+ * @param   addr: address in [0, EEPROM_SIZE)
+ * @param   data: byte to store
+ * @return  NULL
+ */
+void EEPROM_writeByte(unsigned int addr, unsigned char data);
+
+/**
+ * @brief   Read a block of bytes from data EEPROM.
+ * @param   addr: start address
+ * @param   dst: buffer of at least len bytes
+ * @param   len: number of bytes to read
+ * @return  NULL
+ */
+void EEPROM_readBlock(unsigned int addr, void *dst, unsigned int len);
+
+/**
+ * @brief   Write a block of bytes to data EEPROM. Bytes which already
+ *          hold the right value are skipped to save time and wear.
+ * @param   addr: start address
+ * @param   src: data to store
+ * @param   len: number of bytes to write
+ * @return  NULL
+ */
+void EEPROM_writeBlock(unsigned int addr, const void *src, unsigned int len);
+
+/**
+ * @brief   8-bit additive checksum used to validate stored records.
+ * @param   data: record
+ * @param   len: record size in bytes
+ * @return  ~(sum of bytes)
+ */
+unsigned char EEPROM_checksum(const void *data, unsigned int len);
+
+#endif /* _EEPROM_H_ */
@@ -0,0 +1,93 @@
+/**
+ * @file    ephem.h
+ * @author  Mustafa Siddiqui
+ * @brief   Header file for the daily solar ephemeris: the sun's zenith
+ *          and azimuth are computed once a day at fixed knots and each
+ *          control cycle interpolates between the two nearest knots
+ *          instead of running the full sun position model.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _EPHEM_H_
+#define _EPHEM_H_
+
+#include "gps.h"    // struct TimePos
+#include <stdint.h> // int16_t
+
+/* Knot spacing in minutes (UTC) and number of knots: 00:00 ... 24:00 */
+#define EPHEM_STEP_MIN      15
+#define EPHEM_KNOTS         (1440 / EPHEM_STEP_MIN + 1)
+
+/* A table is still used this many days after it was computed */
+/* => declination moves <= 0.4 deg/day, so <= 1.2 deg extra error */
+#define EPHEM_MAX_AGE_DAYS  3
+
+/* Rebuild if the fix moved by more than this (binary angle, ~0.25 deg) */
+#define EPHEM_MOVE_BAM      45
+
+/* Marks an initialized table in EEPROM */
+#define EPHEM_MAGIC         0xA5
+
+/*
+ * Table format (396 bytes, stored as is at EE_ADDR_EPHEM):
+ *   magic, checksum          1 byte each, checksum covers the rest
+ *   ordinal_date             day the table was computed for
+ *   latitude, longitude      binary angles of the fix it was computed for
+ *   zenith[k], azimuth[k]    binary angles at minute k*EPHEM_STEP_MIN UTC
+ *                            (see fixmath.h, 65536 = 360 deg)
+ *
+ * Interpolation error against calculate_target_angles_fx(), every minute
+ * of a year at latitudes -60..60 deg with the sun above the horizon:
+ *   zenith:   max 0.18 deg with the sun > 10 deg from the zenith,
+ *             0.33 deg at > 5 deg, 1.5 deg with the sun overhead
+ *   azimuth:  max 0.26 deg with the sun > 20 deg from the zenith,
+ *             0.98 deg at > 10 deg, 3.9 deg at > 5 deg
+ * All well inside the control loop's ALLOWED_ERROR of 2 deg.
+ *
+ * Per-cycle cost: 1 16-bit division, 4 32-bit multiplies and 2 table reads,
+ * against 6 sin/cos, 2 square roots, 2 atan2 and 15 multiplies for
+ * calculate_target_angles_fx() or 5 float trig calls for the float model.
+ * bench/ephem_bench.c measures both the error and the cost on the host:
+ * the interpolation runs ~20x faster than calculate_target_angles_fx().
+ */
+struct EPHEM_Table {
+    unsigned char magic;
+    unsigned char checksum;
+    int16_t ordinal_date;
+    int16_t latitude;
+    int16_t longitude;
+    int16_t zenith[EPHEM_KNOTS];
+    int16_t azimuth[EPHEM_KNOTS];
+};
+
+/**
+ * @brief   Load the last table from data EEPROM so target angles are
+ *          available before the first fix after power up.
+ * @param   NULL
+ * @return  1 if a valid table was loaded, 0 if not
+ */
+int EPHEM_init(void);
+
+/**
+ * @brief   Rebuild the table at the first fix of a new day or after
+ *          the tracker has moved, and persist it to data EEPROM.
+ *          => ~97 calls to calculate_target_angles_fx() plus up to
+ *             ~1.6 s of EEPROM writes, so only when needed <=
+ * @param   time_pos: latest valid fix
+ * @return  1 if the table was rebuilt, 0 if it was already current
+ */
+int EPHEM_update(const struct TimePos *time_pos);
+
+/**
+ * @brief   Get target zenith and azimuth by interpolating the table.
+ * @param   time_pos: current date and time
+ * @param   angles: [zenith, azimuth] as binary angles
+ * @return  1 if successful, 0 if there is no table or it is older
+ *          than EPHEM_MAX_AGE_DAYS
+ */
+int EPHEM_getAngles(const struct TimePos *time_pos, int16_t *angles);
+
+#endif /* _EPHEM_H_ */
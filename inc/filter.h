@@ -0,0 +1,128 @@
+/**
+ * @file    filter.h
+ * @author  Mustafa Siddiqui
+ * @brief   Header file for streaming filters on integer sensor data.
+ *          Each filter is fed one sample at a time from the data-ready
+ *          interrupts and always holds its current output, so readers
+ *          never wait for a batch of fresh samples.
+ *          => every push is O(1) (the median is O(N^2) in its small
+ *             fixed N), no division except in FILTER_avgGet() <=
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _FILTER_H_
+#define _FILTER_H_
+
+#include <stdint.h> // int16_t, int32_t, uint32_t
+
+/* Longest moving average window */
+#define FILTER_MAX_WINDOW   8
+
+/* Median window => odd, 3 rejects a single-sample spike */
+#define FILTER_MEDIAN_LEN   3
+
+/* Moving average over the last len samples */
+struct FILTER_Avg {
+    int16_t window[FILTER_MAX_WINDOW];
+    int32_t sum;                // running sum of the window
+    unsigned char len;          // window length, <= FILTER_MAX_WINDOW
+    unsigned char head;         // next slot to overwrite
+    unsigned char count;        // samples in the window, <= len
+};
+
+/* Median of the last FILTER_MEDIAN_LEN samples */
+struct FILTER_Median {
+    int16_t window[FILTER_MEDIAN_LEN];
+    unsigned char head;
+    unsigned char count;
+};
+
+/* Exponential moving average: y += (x - y) / 2^shift */
+struct FILTER_Ema {
+    int32_t state;              // output in Q8
+    unsigned char shift;        // time constant ~2^shift samples
+    unsigned char primed;       // first sample loaded
+};
+
+/**
+ * @brief   Empty a moving average and set its window length.
+ * @param   f: filter
+ * @param   len: window length, clamped to [1, FILTER_MAX_WINDOW]
+ * @return  NULL
+ */
+void FILTER_avgInit(struct FILTER_Avg *f, unsigned char len);
+
+/**
+ * @brief   Add a sample, dropping the oldest once the window is full.
+ *          The running sum is updated, not recomputed.
+ * @param   f: filter
+ * @param   x: new sample
+ * @return  NULL
+ */
+void FILTER_avgPush(struct FILTER_Avg *f, int16_t x);
+
+/**
+ * @brief   Mean of the samples in the window.
+ * @param   f: filter
+ * @return  mean, 0 if no sample has been pushed
+ */
+int16_t FILTER_avgGet(const struct FILTER_Avg *f);
+
+/**
+ * @brief   Variance of the samples in the window, O(len).
+ * @param   f: filter
+ * @return  sum((x - mean)^2) / count, saturates at UINT32_MAX,
+ *          0 if no sample has been pushed
+ */
+uint32_t FILTER_avgVariance(const struct FILTER_Avg *f);
+
+/**
+ * @brief   Median of three values.
+ * @param   a, b, c: values
+ * @return  the middle one
+ */
+int16_t FILTER_median3(int16_t a, int16_t b, int16_t c);
+
+/**
+ * @brief   Empty a median filter.
+ * @param   f: filter
+ * @return  NULL
+ */
+void FILTER_medianInit(struct FILTER_Median *f);
+
+/**
+ * @brief   Add a sample and return the median of the window. Until
+ *          the window has filled the median of what is there is used.
+ * @param   f: filter
+ * @param   x: new sample
+ * @return  median
+ */
+int16_t FILTER_medianPush(struct FILTER_Median *f, int16_t x);
+
+/**
+ * @brief   Reset an exponential moving average.
+ * @param   f: filter
+ * @param   shift: smoothing, 1 => y += (x - y) / 2, ..., max 15
+ * @return  NULL
+ */
+void FILTER_emaInit(struct FILTER_Ema *f, unsigned char shift);
+
+/**
+ * @brief   Add a sample. The first one is taken as is.
+ * @param   f: filter
+ * @param   x: new sample
+ * @return  NULL
+ */
+void FILTER_emaPush(struct FILTER_Ema *f, int16_t x);
+
+/**
+ * @brief   Current output of an exponential moving average.
+ * @param   f: filter
+ * @return  output rounded to the nearest integer, 0 before any sample
+ */
+int16_t FILTER_emaGet(const struct FILTER_Ema *f);
+
+#endif /* _FILTER_H_ */
@@ -0,0 +1,93 @@
+/**
+ * @file    fixmath.h
+ * @author  Mustafa Siddiqui
+ * @brief   Header file for integer-only trig used in place of the
+ *          software-float math library on the PIC18 (no FPU).
+ *          => angles are 16-bit binary angles (BAM): 65536 = 360 deg,
+ *             so angle arithmetic wraps around for free <=
+ *          => sin/cos results are Q15: 32767 = 1.0 <=
+ *          => error bounds below are checked against libm by
+ *             test/test_fixmath.c on the host build <=
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _FIXMATH_H_
+#define _FIXMATH_H_
+
+#include <stdint.h> // int16_t, int32_t, uint16_t, uint32_t
+
+/* Q15 representation of 1.0 */
+#define FX_ONE          32767
+
+/* binary angle constants */
+#define FX_BAM_90       16384
+#define FX_BAM_180      32768UL
+
+/* conversions between binary angles and degrees */
+#define FX_DEG_TO_BAM(deg)  ((int16_t)((int32_t)(deg) * 65536L / 360))
+#define FX_BAM_TO_DEG(bam)  ((int)(((int32_t)(int16_t)(bam) * 360L + 32768L) >> 16))
+#define FX_BAM_TO_CDEG(bam) ((int)(((int32_t)(int16_t)(bam) * 36000L + 32768L) >> 16))
+
+/* as FX_BAM_TO_DEG() but in [0, 360) => azimuths west of south are */
+/* 180-360 deg, not negative */
+#define FX_BAM_TO_DEG360(bam)   ((FX_BAM_TO_DEG(bam) + 360) % 360)
+
+/**
+ * @brief   Sine of a binary angle. Quarter-wave table of 65 entries with
+ *          linear interpolation => max error 4 LSB (1.2e-4).
+ * @param   angle: binary angle
+ * @return  sin(angle) in Q15
+ */
+int16_t FX_sin(uint16_t angle);
+
+/**
+ * @brief   Cosine of a binary angle => FX_sin(angle + 90 deg).
+ * @param   angle: binary angle
+ * @return  cos(angle) in Q15
+ */
+int16_t FX_cos(uint16_t angle);
+
+/**
+ * @brief   Quadrant-aware arctan(y/x). Octant reduction, one 16-bit
+ *          division and a 33 entry table with linear interpolation
+ *          => max error 0.02 deg. x and y only need the same scale.
+ * @param   y: y component
+ * @param   x: x component
+ * @return  binary angle, [-180, 180) deg => -180 for y = 0, x < 0
+ *          since +180 does not fit; 0 if x = y = 0
+ */
+int16_t FX_atan2(int32_t y, int32_t x);
+
+/**
+ * @brief   Integer square root (bit-by-bit, 16 iterations, no division).
+ * @param   num: value to take the root of
+ * @return  floor(sqrt(num))
+ */
+uint16_t FX_isqrt(uint32_t num);
+
+/**
+ * @brief   Length of a 3-axis vector, sqrt(x^2 + y^2 + z^2). The sum of
+ *          squares of int16 components fits 32 bits unsigned, so there
+ *          is no scaling => rounded to nearest, max error 0.5 LSB over
+ *          the full int16 range. Pass 0 for z for a 2-D length.
+ * @param   x: x component
+ * @param   y: y component
+ * @param   z: z component
+ * @return  |v| rounded, at most 56756
+ */
+uint16_t FX_magnitude(int16_t x, int16_t y, int16_t z);
+
+/**
+ * @brief   Arccosine as atan2(sqrt(1 - c^2), c) => max error 0.02 deg
+ *          over all Q15 inputs. When the vector is at hand prefer
+ *          FX_atan2() of its components: it avoids the division into
+ *          Q15 and keeps full resolution near 0 and 180 deg.
+ * @param   c: cosine in Q15, clamped to [-1, 1]
+ * @return  binary angle, [0, 180] deg
+ */
+uint16_t FX_acos(int16_t c);
+
+#endif /* _FIXMATH_H_ */
@@ -0,0 +1,79 @@
+/**
+ * @file    gpsaid.h
+ * @author  Carter Bordeleau, Mustafa Siddiqui
+ * @brief   Header file for aiding the EM506's start: the last good fix
+ *          is kept in data EEPROM and sent back to the receiver with
+ *          SiRF $PSRF104 at boot, so it does not have to search for
+ *          satellites from scratch. Time to first fix is measured so
+ *          aided and cold starts can be compared.
+ *          => the stored time lags by however long the power was off,
+ *             so the aid helps most after short outages <=
+ *          => needs the PIC's TX (RC6) wired to the EM506's RX <=
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _GPSAID_H_
+#define _GPSAID_H_
+
+#include "gps.h"    // struct TimePos
+
+/* Marks an initialized record in EEPROM */
+#define GPSAID_MAGIC        0x5A
+
+/* Seconds between saves of the last fix => <= 24 writes a day */
+#define GPSAID_SAVE_S       3600UL
+
+/* GPS time is ahead of UTC by the leap seconds since 1980 */
+#define GPSAID_LEAP_S       18
+
+/* $PSRF104 ResetCfg: 3 = warm start using the position/time sent */
+#define GPSAID_RESET_CFG    3
+
+/* Channels the receiver may use */
+#define GPSAID_CHANNELS     12
+
+/* Record stored at EE_ADDR_GPSAID */
+struct GPSAID_Record {
+    unsigned char magic;
+    unsigned char checksum;     // EEPROM_checksum() of fix
+    struct TimePos fix;
+};
+
+/**
+ * @brief   Load the last fix from EEPROM and, if there is one, send
+ *          it to the receiver with $PSRF104. Starts the time to first
+ *          fix measurement.
+ *          => call after UART_RX_Init() and initRTC(), and before
+ *             initGPSConfig() changes the baud rate
+ * @param   NULL
+ * @return  1 if the receiver was aided, 0 if it is cold starting
+ */
+int initGPSAid(void);
+
+/**
+ * @brief   Send $PSRF104 with a position and time.
+ * @param   time_pos: fix to initialize the receiver with
+ * @return  NULL
+ */
+void GPSAID_sendInit(const struct TimePos *time_pos);
+
+/**
+ * @brief   Report a valid fix. The first one stops the time to first
+ *          fix measurement and is saved; after that a fix is saved
+ *          every GPSAID_SAVE_S seconds.
+ * @param   time_pos: latest fix
+ * @return  1 if this was the first fix of this boot, 0 if not
+ */
+int GPSAID_fix(const struct TimePos *time_pos);
+
+/**
+ * @brief   Time to first fix of this boot.
+ * @param   aided: set to 1 if $PSRF104 was sent at boot, 0 if not
+ * @return  seconds from initGPSAid() to the first fix, 0 if no fix yet
+ */
+unsigned int GPSAID_getTTFF(unsigned char *aided);
+
+#endif /* _GPSAID_H_ */
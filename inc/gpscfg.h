@@ -0,0 +1,121 @@
+/**
+ * @file    gpscfg.h
+ * @author  Carter Bordeleau, Mustafa Siddiqui
+ * @brief   Header file for configuring which NMEA sentences the EM506
+ *          sends and how often, using SiRF $PSRF103 commands.
+ *          => by default the receiver streams GGA/GSA/GSV/RMC, and only
+ *             RMC and GGA are used, so much of the UART traffic is
+ *             thrown away <=
+ *          Once only wanted sentences are coming in, the link is moved
+ *          above the receiver's 9600 baud default with $PSRF100.
+ *          => needs the PIC's TX (RC6) wired to the EM506's RX <=
+ * @date    10/16/2026
+ * 
+ * 
+ */
+
+#ifndef GPSCFG_H
+#define	GPSCFG_H
+
+/* SiRF NMEA message IDs for $PSRF103 */
+#define SIRF_GGA    0
+#define SIRF_GLL    1
+#define SIRF_GSA    2
+#define SIRF_GSV    3
+#define SIRF_RMC    4
+#define SIRF_VTG    5
+#define SIRF_ZDA    8
+
+/* Seconds between RMC sentences */
+#define GPSCFG_RMC_RATE     1
+
+/* Seconds between GGA sentences => fix quality, satellites and HDOP */
+#define GPSCFG_GGA_RATE     1
+
+/* Seconds of traffic counted for each sentence mix measurement */
+#define GPSCFG_WINDOW_S     10
+
+/* Seconds ignored after sending the commands */
+#define GPSCFG_SETTLE_S     2
+
+/* Seconds of traffic that must pass checksum after a baud change */
+#define GPSCFG_BAUD_WINDOW_S 3
+
+/* Rates tried in order, see UART_set_baud() for the divisor error */
+#define GPSCFG_BAUD_RATES   {57600UL, 38400UL}
+
+/* configuration progress, see GPSCFG_service() */
+enum gpscfgState {
+    GPSCFG_MEASURE_DEFAULT,     // measuring the receiver's own sentence mix
+    GPSCFG_SETTLE,              // commands sent, waiting for them to apply
+    GPSCFG_VERIFY,              // measuring the mix after configuring
+    GPSCFG_CONFIGURED,          // only wanted sentences seen
+    GPSCFG_BAUD_CONFIRM         // $PSRF100 sent, waiting for clean sentences
+};
+
+/* what the measurements found */
+struct GPSCFG_Report {
+    unsigned int bytes_per_fix_before;  // received bytes per usable fix, default mix
+    unsigned int bytes_per_fix_after;   // same, after configuring
+                                        // => 0xFFFF if there was no fix
+    unsigned long baud;                 // current link rate
+    unsigned char attempts;             // times the commands were sent
+    unsigned char baud_attempts;        // times $PSRF100 was sent
+    unsigned char lost_windows;         // windows that lost UART RX bytes
+    unsigned char state;                // enum gpscfgState
+};
+
+/**
+ * @brief   Start by measuring the default sentence mix. The commands
+ *          are sent from GPSCFG_service() once that window is over.
+ *          => needs initRTC() and UART_RX_Init() first
+ * @param   NULL
+ * @return  NULL
+ */
+void initGPSConfig(void);
+
+/**
+ * @brief   Send a $PSRF103 rate command for every sentence type: RMC
+ *          every GPSCFG_RMC_RATE seconds, GGA every GPSCFG_GGA_RATE
+ *          seconds, everything else off.
+ * @param   NULL
+ * @return  NULL
+ */
+void GPSCFG_sendCommands(void);
+
+/**
+ * @brief   Send $PSRF100 at the current rate, wait for it to go out,
+ *          then switch the UART to the new rate.
+ * @param   baud: new link rate
+ * @return  NULL
+ */
+void GPSCFG_setBaud(unsigned long baud);
+
+/**
+ * @brief   Advance the configure/verify sequence. Compares the
+ *          sentence mix counted by the NMEA parser (get_NMEA_Stats())
+ *          over GPSCFG_WINDOW_S windows. If unwanted sentences show up
+ *          again (receiver reset or command lost) the commands are
+ *          resent. Once configured, each rate in GPSCFG_BAUD_RATES is
+ *          tried until RMC sentences pass checksum at it; a rate that
+ *          fails is undone with $PSRF100 back to UART_DEFAULT_BAUD.
+ *          If the link goes silent at a raised rate (receiver reset to
+ *          its default) the UART drops back and the sequence restarts.
+ *          A window in which the UART lost RX bytes (UART_get_stats())
+ *          is not used, a new one is started in its place; after a
+ *          baud change it fails the new rate, as the main code does not
+ *          poll often enough to keep up with it.
+ *          Call regularly, after GPS data has been polled.
+ * @param   NULL
+ * @return  current state => enum gpscfgState
+ */
+int GPSCFG_service(void);
+
+/**
+ * @brief   Copy what the measurements found so far.
+ * @param   report: destination
+ * @return  NULL
+ */
+void GPSCFG_getReport(struct GPSCFG_Report *report);
+
+#endif	/* GPSCFG_H */
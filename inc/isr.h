@@ -0,0 +1,28 @@
+/**
+ * @file    isr.h
+ * @author  Mustafa Siddiqui
+ * @brief   Header file for the interrupt service routine.
+ *          => the PIC18 is run with interrupt priorities: UART, Timer1
+ *             and the PPS input on the high vector, the sensor
+ *             data-ready pins on the low vector, whose handlers spend
+ *             ~0.5 ms per SPI transfer and must not hold off UART RX.
+ *             Each module's handlers are dispatched from isr.c <=
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _ISR_H_
+#define _ISR_H_
+
+/**
+ * @brief   Enable peripheral and global interrupts. Each module enables
+ *          its own interrupt sources in its init function; this only 
+ *          opens the gate. Should be called right after initPins().
+ * @param   NULL
+ * @return  NULL
+ */
+void initInterrupts(void);
+
+#endif /* _ISR_H_ */
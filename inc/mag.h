@@ -14,6 +14,7 @@
 #define _MAG_H_
 
 #include <stdint.h> // int16_t
+#include "sample.h" // struct SensorSample
 
 /* Register Maps */
 // Hard Iron Registers (Both Read and Write)
@@ -45,27 +46,23 @@
 
 #define DECLINATION -11.25 //magnetic declination of rochester
 
-// Utility Macros to set/clear individual bits in a register
-#define SET(reg, bitNum)   (reg |= (1 << bitNum))
-#define CLEAR(reg, bitNum) (reg &= ~(1 << bitNum))
+// Angle from the sensor's x axis to the tracker's heading, in degrees
+// => fixed by how the board is mounted, measure once at install
+#define MAG_MOUNT_OFFSET    0
 
-// Number of axis readings the sensor reads
-#define NUM_AXIS        3 
+// DRDY pin => RB2/INT2, high while OUT* holds an unread sample
+#define MAG_DRDY_PIN    TRISBbits.TRISB2
 
-// Number of readings to average
-#define NUM_READINGS    10
-
-// Offsets -- hardcoded
-int16_t xAxisMagOffset = 380;
-int16_t yAxisMagOffset = 160;
+// Longest wait for a new sample, 2.5 periods at the slowest rate (10 Hz)
+#define MAG_SAMPLE_TIMEOUT_MS   250
 
-// Calibrate to 0
-int16_t initialOff = 0;
+// Medians of 3 in the moving average behind MAG_getFiltered()
+// => with the median the state depends on the last 10 samples, 200 ms
+//    at 50 Hz, shorter than the shortest settle (ACCEL_waitSettled())
+#define MAG_FILTER_LEN          8
 
-// create data packet to write to magnetometer
-// RW: read/write
-// address: address of register
-unsigned char Create_MagData(int RW, unsigned char address);
+// Number of readings to average
+#define MAG_NUM_READINGS        10
 
 // write to register
 // address: address of register
@@ -79,16 +76,49 @@ unsigned char MAG_Read(unsigned char address);
 // read content stored in WHO_AM_I register
 unsigned char Get_MAG_ID(void);
 
-// intiliaze magnetometer: CFG_REG_A and CFG_REG_C
+// read consecutive registers in one ~CS low transaction
+// address: first register, data: buffer of len bytes
+void MAG_ReadBurst(unsigned char address, uint8_t* data, unsigned char len);
+
+// intiliaze magnetometer: offsets, CFG_REG_A/B from the calibration
+// profile (see sensorcfg.h), CFG_REG_C, DRDY on RB2/INT2
 int Mag_Initialize(void);
 
 // get current sensor reading [x,y,z]
+// => one burst read of OUTX_L..OUTZ_H
 void MAG_Data(int16_t* sensorData);
 
-// get average of NUM_READINGS sensor readings
+// combine the 6 bytes of an OUTX_L..OUTZ_H burst into [x,y,z]
+void MAG_Combine(const uint8_t* raw, int16_t* sensorData);
+
+// copy the sample last captured by MAG_ISR()
+// sample: in => sample last used (seq 0 if none), out => latest if newer
+// returns 1 if *sample was updated with a fresh sample
+int MAG_getSample(struct SensorSample* sample);
+
+// copy the filtered state: per axis, the median of the last 3 samples
+// averaged over the last MAG_FILTER_LEN medians, updated on every DRDY
+// sample: count = medians in the average, seq/ticks of the newest sample
+// returns 1 if at least one sample has been filtered
+int MAG_getFiltered(struct SensorSample* sample);
+
+// DRDY handler: queue a read of the new sample (see SPI_submit()),
+// when it is done the sample goes into the slot with the DRDY Timer1
+// timestamp and the next sequence number, then into the streaming
+// filters, runs at low priority
+void MAG_ISR(void);
+
+// get average of MAG_NUM_READINGS sensor readings
 void MAG_AvgData(int32_t* avgData);
 
-// calculate azimuth angle in degrees
+// convert a heading (binary angle of north from the sensor's x axis
+// towards y, see fixmath.h) to azimuth in degrees: declination and
+// MAG_MOUNT_OFFSET applied, angle = [0, 360)
+int MAG_Azimuth(int16_t angle);
+
+// calculate azimuth angle in degrees from the filtered state, corrected
+// for soft iron (see magcal.h), declination and MAG_MOUNT_OFFSET
+// => only waits (up to MAG_SAMPLE_TIMEOUT_MS) if there is none yet
 // angle = [0, 360)
 int MAG_Angle(void);
 
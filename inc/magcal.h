@@ -0,0 +1,108 @@
+/**
+ * @file    magcal.h
+ * @author  Ali Choudhry, Mustafa Siddiqui
+ * @brief   Header file for hard/soft-iron calibration of the
+ *          magnetometer. The horizontal motor turns the tracker through
+ *          a full turn while x,y samples are collected, an ellipse is
+ *          fitted to them, and its centre (hard iron) goes to the
+ *          LIS2MDL offset registers through the sensor profile while
+ *          its shape (soft iron) is kept as a 2x2 Q14 matrix that
+ *          MAG_Angle() applies to every reading.
+ *          => the tracker only turns about its vertical axis, so the fit
+ *             is a 2-D ellipse in x,y; z keeps its profile offset <=
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _MAGCAL_H_
+#define _MAGCAL_H_
+
+#include <stdint.h> // int16_t
+
+/* Marks an initialized record in EEPROM */
+#define MAGCAL_MAGIC            0x3C
+
+/* Soft-iron matrix fixed point => 16384 = 1.0 */
+#define MAGCAL_Q                14
+#define MAGCAL_ONE              (1 << MAGCAL_Q)
+
+/* Samples kept for the fit => halved (every other one dropped) when */
+/* full, so they always span the whole sweep */
+#define MAGCAL_SAMPLES          64
+
+/* Sweep => same duty cycle as move_horizontal_to_angle() */
+#define MAGCAL_SWEEP_SPEED      25
+#define MAGCAL_SWEEP_DIR        CLOCKWISE
+#define MAGCAL_TIMEOUT_S        120
+
+/* Sweep is done after 1.1 turns around the running centre (binary angle) */
+#define MAGCAL_TURN             72090L
+
+/* Least half-range in counts before the turn is tracked */
+/* => earth's horizontal field ~ 0.17 G = 113 counts at 1.5 mG/LSB */
+#define MAGCAL_MIN_RADIUS       40
+
+/* Fit rejected if its axes differ by more than 2:1 or the samples */
+/* scatter more than 10% of the radius around it */
+#define MAGCAL_MAX_RATIO        2.0f
+#define MAGCAL_MAX_RESIDUAL     10
+
+/* Record stored at EE_ADDR_MAGCAL */
+struct MAGCAL_Record {
+    unsigned char magic;
+    unsigned char checksum;     // EEPROM_checksum() of softIron
+    int16_t softIron[4];        // [xx, xy, yx, yy] in Q14
+};
+
+/* Result of MAGCAL_fit() */
+struct MAGCAL_Fit {
+    int16_t center[2];          // hard iron, counts
+    int16_t softIron[4];        // [xx, xy, yx, yy] in Q14
+    int16_t radius;             // mean radius after correction, counts
+    unsigned char residual;     // rms scatter, % of radius
+};
+
+/**
+ * @brief   Load the soft-iron matrix from EEPROM, or the identity if
+ *          no calibration has been stored.
+ * @param   NULL
+ * @return  1 if a calibration was loaded, 0 if not
+ */
+int initMagCal(void);
+
+/**
+ * @brief   Calibrate: turn the tracker with the horizontal motor until it
+ *          has gone through MAGCAL_TURN (or MAGCAL_TIMEOUT_S), fit an
+ *          ellipse to the samples, then store and apply the result.
+ *          => needs Mag_Initialize(), pwm_Init() and the DRDY interrupt;
+ *             the tracker ends up about a tenth of a turn past where
+ *             it started <=
+ * @param   NULL
+ * @return  residual in % of radius if stored, -1 if the sweep or fit
+ *          failed (the old calibration is kept)
+ */
+int MAGCAL_run(void);
+
+/**
+ * @brief   Least squares fit of A x^2 + B xy + C y^2 + D x + E y = 1 to
+ *          the samples, in float (runs once per calibration). Points are
+ *          centred and scaled by their bounding box first so the sums
+ *          keep their precision in 32-bit float.
+ * @param   xy: samples as [x, y] pairs
+ * @param   n: number of samples, >= 5
+ * @param   fit: filled with the centre, matrix and quality
+ * @return  1 if the samples lie on a plausible ellipse, 0 if not
+ */
+int MAGCAL_fit(const int16_t (*xy)[2], unsigned char n, struct MAGCAL_Fit *fit);
+
+/**
+ * @brief   Apply the soft-iron matrix to x,y in place. z is left as is.
+ *          => two 16x16 multiplies per axis <=
+ * @param   sensorData: [x, y, z] with the hard iron already removed
+ * @return  NULL
+ */
+void MAGCAL_correct(int16_t *sensorData);
+
+#endif /* _MAGCAL_H_ */
@@ -0,0 +1,119 @@
+/**
+ * @file    nmea.h
+ * @author  Carter Bordeleau, Mustafa Siddiqui
+ * @brief   Header file for decoding NMEA sentences: the byte-at-a-time
+ *          parser used on the GPS UART stream and the older whole
+ *          sentence helpers. Plain C99, no xc.h, so the parser can be
+ *          compiled and exercised on a host before flashing.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef NMEA_H
+#define	NMEA_H
+
+/* longest sentence allowed by NMEA 0183, '$' to '\n' */
+#define NMEA_MAX_LEN    82
+
+struct TimePos {
+    int ordinal_date;       //day of the year Jan 1 = 1
+    int time;               //minute of the day 0 = midnight
+    float latitude; 
+    float longitude;
+    unsigned char second;   //second of the minute
+    unsigned char year;     //years since 2000
+};
+
+#define NMEA_FIELD_LEN 12   //longest field we decode is lon "dddmm.mmmm"
+
+/*
+ * sentence types decoded, from any talker ID ($GP, $GN, $GL, ...)
+ * => the type is looked up once, when the address field ends; any other
+ *    sentence is dropped there and its remaining bytes are only counted
+ * => cost per sentence type: bench/dispatch_bench.c on the host build;
+ *    a skipped sentence only has its bytes counted, the
+ *    decoded ones about 1.5-3x that as fields are converted on arrival
+ */
+#define NMEA_RMC        1   //time, date, position, status
+#define NMEA_GGA        2   //time, position, fix quality, satellites, HDOP, altitude
+#define NMEA_ZDA        3   //time and date only => usable without a fix
+
+/* bits of NMEA_Fix.valid => set per field, see parse_NMEA_char() */
+#define FIX_TIME        0x01
+#define FIX_DATE        0x02
+#define FIX_POS         0x04    //lat/lon with RMC status 'A' or GGA quality > 0
+#define FIX_QUALITY     0x08
+#define FIX_SATS        0x10
+#define FIX_HDOP        0x20
+#define FIX_ALT         0x40
+
+/* fix quality gate, see NMEA_fix_usable() */
+#define NMEA_MIN_SATS   4       //3D fix
+#define NMEA_MAX_HDOP   50      //tenths => 5.0
+
+/*
+ * everything known about the receiver's latest fix
+ * => each sentence updates only the fields it carries, and a field it
+ *    carries but left empty is marked invalid
+ */
+struct NMEA_Fix {
+    unsigned char valid;    //FIX_* bits
+    unsigned char quality;  //GGA fix quality, 0 = none, 1 = GPS, 2 = DGPS
+    unsigned char satellites;
+    unsigned char second;   //second of the minute
+    unsigned char year;     //years since 2000
+    int ordinal_date;       //day of the year Jan 1 = 1
+    int time;               //minute of the day 0 = midnight
+    unsigned int hdop;      //tenths
+    long altitude;          //decimeters above mean sea level
+    float latitude;
+    float longitude;
+};
+
+/*
+ * running counters kept by each parser
+ */
+struct NMEA_Stats {
+    unsigned long bytes;    //bytes fed to the parser
+    unsigned int rmc;       //RMC sentences with a good checksum, fix or not
+    unsigned int gga;       //same for GGA
+    unsigned int zda;       //same for ZDA
+    unsigned int fixes;     //usable time and positions returned
+    unsigned int other;     //sentences of any other type that were skipped
+};
+
+/*
+ * state of the byte-at-a-time NMEA parser
+ * => fields are decoded as soon as their terminating ',' arrives and
+ *    the fix is updated the moment the checksum byte lands
+ */
+struct NMEA_Parser {
+    unsigned char state;        //see NMEA_* states in nmea.c
+    unsigned char checksum;     //running XOR of the bytes between '$' and '*'
+    unsigned char rx_checksum;  //checksum sent by the receiver
+    unsigned char field;        //index of the field being received, 0 = address
+    unsigned char len;          //number of chars in field_buf
+    unsigned char sentence;     //NMEA_RMC/GGA/ZDA being received, 0 = none
+    unsigned int seen;          //FIX_* and partial field bits decoded so far
+    char date[7];               //ZDA date as DDMMYY, filled field by field
+    char field_buf[NMEA_FIELD_LEN + 1];
+    struct NMEA_Fix work;       //fields of the sentence being received
+    struct NMEA_Fix fix;        //merged from every intact sentence
+    struct NMEA_Stats stats;
+};
+
+struct TimePos parse_GPRMC(const char*);
+int is_GPRMC(const char*);
+int is_Valid_GPRMC(char*);
+int calc_NMEA_Checksum( char *, int);
+int str_to_ordinal_date(char*);
+int str_to_minute(char*);
+float str_to_latitude(char*);
+float str_to_longitude(char*);
+void init_NMEA_Parser(struct NMEA_Parser*);
+int parse_NMEA_char(struct NMEA_Parser*, char, struct TimePos*);
+int NMEA_fix_usable(const struct NMEA_Fix*);
+
+#endif	/* NMEA_H */
@@ -0,0 +1,125 @@
+/**
+ * @file    orient.h
+ * @author  Mustafa Siddiqui
+ * @brief   Header file for the fused orientation: zenith from the
+ *          ADXL343 gravity vector, and a tilt-compensated azimuth from
+ *          the LIS2MDL field vector projected into the horizontal plane
+ *          that gravity defines.
+ *          ORIENT_ISR() also tracks both angles over time with an
+ *          alpha-beta filter (angle and rate, no gyro to integrate), so
+ *          a smoothed estimate can be read at any time without waiting.
+ *          => assumes both sensors' x,y,z axes are parallel with the
+ *             same signs; remap with ORIENT_MAG_X/Y/Z() if the boards
+ *             are mounted differently <=
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _ORIENT_H_
+#define _ORIENT_H_
+
+#include <stdint.h> // int16_t, uint16_t, uint32_t
+
+/* Magnetometer axes in the accelerometer's frame */
+#define ORIENT_MAG_X(m)     ((m)[0])
+#define ORIENT_MAG_Y(m)     ((m)[1])
+#define ORIENT_MAG_Z(m)     ((m)[2])
+
+/* Unit gravity vector scale => Q14 keeps every product in 32 bits */
+#define ORIENT_Q            14
+
+/* Largest time between the two samples of a pair, ms */
+/* => both sensors deliver every 20-50 ms, more means one has stalled */
+#define ORIENT_MAX_SKEW_MS  100
+
+/* Alpha-beta filter gains as shifts, per accelerometer block (20 Hz) */
+/*      angle += residual / 2^ALPHA, rate += residual / 2^BETA */
+/*      => 1/4, 1/32: settles in ~0.5 sec, follows a turning motor */
+/*         without lag once the rate has been picked up */
+#define ORIENT_ALPHA_SHIFT  2
+#define ORIENT_BETA_SHIFT   5
+
+/* Gravity check => blocks more than 20% off 1 g (motor jerks, */
+/* vibration) only advance the angles, they don't correct them */
+#define ORIENT_1G           8192    /* +-4g, left justified */
+#define ORIENT_G_MIN        (ORIENT_1G - ORIENT_1G / 5)
+#define ORIENT_G_MAX        (ORIENT_1G + ORIENT_1G / 5)
+
+/* Without a correction the rate decays by 1/2^DECAY per block, and */
+/* after ORIENT_MAX_COAST blocks in a row (1 sec) the angles are held */
+/* and there is no estimate until a block passes the gravity check */
+/* => a stale rate moves the angle by at most 4x itself */
+#define ORIENT_DECAY_SHIFT  2
+#define ORIENT_MAX_COAST    20
+
+/* Zenith and azimuth from one pair of samples */
+struct ORIENT_Angles {
+    int zenith;             // degrees, as getCurrentZenith()
+    int azimuth;            // degrees [0, 360), as MAG_Angle()
+    int16_t heading;        // binary angle before MAG_Azimuth()
+    uint32_t ticks;         // RTC_getTicks() of the newer sample
+    uint16_t skewMs;        // time between the two samples
+};
+
+/**
+ * @brief   Take the filtered accelerometer and magnetometer states as
+ *          one pair (low priority interrupts held off across both
+ *          copies, so neither moves on in between), then compute
+ *          zenith and tilt-compensated azimuth with integer math:
+ *            u = a / |a| in Q14 (up)
+ *            east  ~ m x u                 => Y = my uz - mz uy
+ *            north ~ m - (m . u) u         => X = mx - (m . u) ux
+ *            heading = atan2(Y, X)
+ *          which is atan2(my, mx), as MAG_Angle(), when level. The x
+ *          axis is the tilt axis and stays horizontal, so the heading
+ *          is defined at every zenith.
+ *          => three 16x16 multiplies for m . u, four more for X and Y,
+ *             one square root and three divisions for u <=
+ * @param   angles: filled with the result
+ * @return  1 if both sensors had samples within ORIENT_MAX_SKEW_MS
+ *          of each other, 0 if not (angles not touched)
+ */
+int ORIENT_getAngles(struct ORIENT_Angles *angles);
+
+/**
+ * @brief   Tilt-compensated heading of the x axis from one gravity and
+ *          one field vector. Split out of ORIENT_getAngles() so it can
+ *          be checked on its own.
+ * @param   accel: [x, y, z] accelerometer reading
+ * @param   mag: [x, y, z] magnetometer reading, calibrated
+ * @return  binary angle of north from x towards the horizontal y
+ */
+int16_t ORIENT_heading(const int16_t *accel, const int16_t *mag);
+
+/**
+ * @brief   Latest estimate from the alpha-beta filter, in constant time.
+ * @param   angles: filled with the estimate, skewMs = time between the
+ *          last pair of samples it used
+ * @return  1 if there is an estimate, 0 before the first sample pair
+ *          or after ORIENT_MAX_COAST blocks failed the gravity check
+ *          (measure the angles directly then)
+ */
+int ORIENT_getEstimate(struct ORIENT_Angles *angles);
+
+/**
+ * @brief   Reset the estimate => the next sample pair starts it again.
+ * @param   NULL
+ * @return  NULL
+ */
+void initOrient(void);
+
+/**
+ * @brief   Update the estimate with each new accelerometer block and
+ *          the newest magnetometer sample: predict angle + rate, then
+ *          correct both by the residual to the measured angles. Angles
+ *          are 32-bit binary angles (BAM << 16), so they and their
+ *          residuals wrap around 360 deg for free. Called from the low
+ *          priority ISR after ACCEL_ISR() and MAG_ISR().
+ * @param   NULL
+ * @return  NULL
+ */
+void ORIENT_ISR(void);
+
+#endif /* _ORIENT_H_ */
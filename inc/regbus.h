@@ -0,0 +1,92 @@
+/**
+ * @file    regbus.h
+ * @author  Mustafa Siddiqui
+ * @brief   Header file for register access to the SPI sensors. Each
+ *          sensor is described once (slave, read bit, multiple byte bit,
+ *          address bits) and every register read or write of both drivers
+ *          goes through here: command byte, ~CS window, data bytes.
+ *          => ~CS line, SPI clock and the byte/transaction counters are
+ *             per slave in spi.c, see SPI_tune() and SPI_getStats() <=
+ * @date    10/16/2026
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _REGBUS_H_
+#define _REGBUS_H_
+
+#include <stdint.h> // uint8_t
+
+/* Register layout of one SPI sensor => command byte [R/W, MB, address] */
+struct REGBUS_Device {
+    unsigned char slave;        // ACCELEROMETER or MAGNETOMETER (spi.h)
+    unsigned char readBit;      // set in the command byte to read
+    unsigned char multiBit;     // set to access several registers, 0 if
+                                // the sensor always increments the address
+    unsigned char addrMask;     // register address bits
+};
+
+/* Direction of a batched access */
+#define REGBUS_READ     1
+#define REGBUS_WRITE    0
+
+/* One access in a batch => len registers from addr */
+struct REGBUS_Op {
+    unsigned char addr;
+    unsigned char dir;          // REGBUS_READ or REGBUS_WRITE
+    uint8_t *data;              // len bytes, read into or written from
+    unsigned char len;
+};
+
+/**
+ * @brief   Command byte that starts an access.
+ * @param   dev: sensor
+ * @param   addr: first register
+ * @param   dir: REGBUS_READ or REGBUS_WRITE
+ * @param   len: registers accessed => the multiple byte bit if > 1
+ * @return  command byte
+ */
+unsigned char REGBUS_command(const struct REGBUS_Device *dev, unsigned char addr, unsigned char dir, unsigned char len);
+
+/**
+ * @brief   Write one register.
+ * @param   dev: sensor
+ * @param   addr: register
+ * @param   data: value to write
+ * @return  0 if successful, -1 if a write collision occurred
+ */
+signed char REGBUS_write(const struct REGBUS_Device *dev, unsigned char addr, unsigned char data);
+
+/**
+ * @brief   Read one register.
+ * @param   dev: sensor
+ * @param   addr: register
+ * @return  content of the register
+ */
+unsigned char REGBUS_read(const struct REGBUS_Device *dev, unsigned char addr);
+
+/**
+ * @brief   Read consecutive registers in one ~CS window, the sensor
+ *          increments the address after each byte.
+ * @param   dev: sensor
+ * @param   addr: first register
+ * @param   data: buffer of at least len bytes
+ * @param   len: number of registers
+ * @return  NULL
+ */
+void REGBUS_readBlock(const struct REGBUS_Device *dev, unsigned char addr, uint8_t *data, unsigned char len);
+
+/**
+ * @brief   Run several accesses back-to-back: the bus is taken once (SPI
+ *          clock set, queue held, low priority interrupts off) and ~CS
+ *          only goes high between accesses to start the next command.
+ *          => no other transaction can come in between <=
+ * @param   dev: sensor
+ * @param   ops: accesses, in order
+ * @param   n: number of accesses
+ * @return  0 if successful, -1 if a write collision occurred
+ */
+signed char REGBUS_batch(const struct REGBUS_Device *dev, const struct REGBUS_Op *ops, unsigned char n);
+
+#endif /* _REGBUS_H_ */
@@ -0,0 +1,116 @@
+/**
+ * @file    rtc.h
+ * @author  Mustafa Siddiqui
+ * @brief   Header file for the software real-time clock.
+ *          => Timer1 runs from Fosc/4 with a 1:8 prescaler (250 kHz
+ *             nominal) and its overflow interrupt advances the clock, so
+ *             time is always available without waiting on the GPS <=
+ *          => every RTC_sync() from a valid GPRMC measures how fast
+ *             Timer1 really runs and trims the ticks counted per second,
+ *             which is what lets the clock hold over between syncs <=
+ *          (RC0/RC1 are in use, so there is no room for a 32 kHz crystal)
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _RTC_H_
+#define _RTC_H_
+
+#include "gps.h"    // struct TimePos
+#include <stdint.h> // int32_t, uint32_t
+
+/* Timer1 ticks per second with a perfect 8 MHz clock: 8e6 / 4 / 8 */
+#define RTC_NOMINAL_TPS     250000UL
+
+/* Limit on the trimmed rate => the internal oscillator is good to ~2% */
+#define RTC_MAX_TRIM_TPS    5000UL
+
+/* Resync from GPS when the last sync is older than this */
+#define RTC_RESYNC_S        600UL
+
+/* Shortest interval between syncs used to estimate drift */
+/* => fixes are picked up within ~100 ms of arriving, so 30 minutes */
+/*    keeps the rate estimate good to ~50 ppm */
+#define RTC_MIN_DRIFT_S     1800UL
+
+/**
+ * @brief   Start Timer1 and its overflow interrupt. The clock does not
+ *          hold a valid time until the first RTC_sync().
+ * @param   NULL
+ * @return  NULL
+ */
+void initRTC(void);
+
+/**
+ * @brief   Set the clock from a valid GPS fix and cache its position.
+ *          If the previous sync is at least RTC_MIN_DRIFT_S old, the
+ *          Timer1 rate is measured against GPS time and used from now on.
+ * @param   time_pos: fix that has just been received
+ * @return  NULL
+ */
+void RTC_sync(const struct TimePos *time_pos);
+
+/**
+ * @brief   Use an externally measured Timer1 rate (e.g. from the GPS
+ *          1PPS, see clkcal.h) instead of the estimate made in
+ *          RTC_sync(), which restarts its measurement window.
+ * @param   tps: Timer1 ticks per second
+ * @return  NULL
+ */
+void RTC_setTicksPerSecond(uint32_t tps);
+
+/**
+ * @brief   Whether the clock has been set since power up.
+ * @param   NULL
+ * @return  1 if synced at least once, 0 if not
+ */
+int RTC_isValid(void);
+
+/**
+ * @brief   Current date and time with the position of the last fix.
+ * @param   time_pos: destination
+ * @return  NULL
+ */
+void RTC_getTimePos(struct TimePos *time_pos);
+
+/**
+ * @brief   Timer1 rate error measured at the last sync, i.e. the
+ *          oscillator error the clock is now compensating for.
+ * @param   NULL
+ * @return  parts per million, positive = running fast
+ */
+int32_t RTC_getDriftPpm(void);
+
+/**
+ * @brief   Seconds since the clock was last set from GPS.
+ * @param   NULL
+ * @return  seconds, 0xFFFFFFFF if never synced
+ */
+uint32_t RTC_getSecondsSinceSync(void);
+
+/**
+ * @brief   Seconds since initRTC(), kept whether synced or not.
+ * @param   NULL
+ * @return  seconds
+ */
+uint32_t RTC_getUptime(void);
+
+/**
+ * @brief   Timer1 ticks since initRTC() (32 bits, wraps every ~4.7 h)
+ *          for timestamping and measuring short intervals.
+ * @param   NULL
+ * @return  ticks of RTC_NOMINAL_TPS nominal rate
+ */
+uint32_t RTC_getTicks(void);
+
+/**
+ * @brief   Timer1 overflow handler, must be called from the interrupt
+ *          routine.
+ * @param   NULL
+ * @return  NULL
+ */
+void RTC_ISR(void);
+
+#endif /* _RTC_H_ */
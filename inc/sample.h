@@ -0,0 +1,33 @@
+/**
+ * @file    sample.h
+ * @author  Mustafa Siddiqui
+ * @brief   Header file for the sample slot each sensor's data-ready
+ *          interrupt fills in. The slot is overwritten by every new
+ *          sample; readers keep the sequence number of the last sample
+ *          they used to tell whether the slot holds a fresh one.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _SAMPLE_H_
+#define _SAMPLE_H_
+
+#include <stdint.h> // int16_t, uint16_t, uint32_t
+
+/* Number of axis readings given by each sensor */
+#define NUM_AXIS        3
+
+/* latest [x,y,z] reading of one sensor */
+struct SensorSample {
+    int16_t axis[NUM_AXIS]; // [x,y,z], sensor offsets applied
+    uint32_t ticks;         // RTC_getTicks() when the interrupt fired
+    uint16_t seq;           // +1 per sample, 0 = nothing captured yet
+    unsigned char count;    // sensor samples averaged into axis
+};
+
+/* next sequence number => skips 0 so it always means "no sample" */
+#define SAMPLE_NEXT_SEQ(seq) ((uint16_t)((seq) + 1) ? (uint16_t)((seq) + 1) : 1)
+
+#endif /* _SAMPLE_H_ */
@@ -0,0 +1,119 @@
+/**
+ * @file    sensorcfg.h
+ * @author  Mustafa Siddiqui
+ * @brief   Header file for programming the sensors' on-chip signal
+ *          conditioning from a calibration profile kept in data EEPROM:
+ *            ADXL343 => OFSX/Y/Z offset registers, BW_RATE output data
+ *                       rate (bandwidth = ODR/2) and low power bit
+ *            LIS2MDL => OFFSET_X/Y/Z hard-iron registers, CFG_REG_A
+ *                       output data rate, CFG_REG_B low-pass filter and
+ *                       offset cancellation
+ *          With the offsets applied inside the sensors a sample is just
+ *          one burst read, no correction is left to the firmware.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _SENSORCFG_H_
+#define _SENSORCFG_H_
+
+#include <stdint.h> // int8_t, int16_t
+
+/* Marks an initialized profile in EEPROM */
+#define SENSORCFG_MAGIC         0xC5
+
+/*
+ * ADXL343 offset registers are 8-bit two's complement at 15.6 mg/LSB
+ * and are added to every sample. In the DATA_FORMAT used by initAccel()
+ * (+-4g, 10-bit, left justified) one data count is 7.8 mg / 64, so one
+ * OFS step = 128 data counts. The old firmware offsets (-192, -192, 320)
+ * round to (-2, -2, 3), i.e. within half a step = 7.8 mg (~0.45 deg tilt).
+ * => change the ratio with DATA_FORMAT <=
+ */
+#define SENSORCFG_ACCEL_OFS_COUNTS  128
+#define SENSORCFG_ACCEL_OFSX        (-2)
+#define SENSORCFG_ACCEL_OFSY        (-2)
+#define SENSORCFG_ACCEL_OFSZ        3
+
+/* BW_RATE => [0, 0, 0, low_power, rate<3:0>] */
+/*      0x0A = 100 Hz, normal power, 50 Hz bandwidth */
+/*      low_power (0x10) saves ~ 50 uA but is noisier */
+#define SENSORCFG_ACCEL_LOW_POWER   0x10
+#define SENSORCFG_ACCEL_BW_RATE     0x0A
+
+/*
+ * LIS2MDL OFFSET_*_REG are 16-bit at 1.5 mG/LSB like the output, and
+ * are subtracted from every sample => the opposite sign of the old
+ * firmware offsets (+380, +160, 0).
+ */
+#define SENSORCFG_MAG_OFFSET_X      (-380)
+#define SENSORCFG_MAG_OFFSET_Y      (-160)
+#define SENSORCFG_MAG_OFFSET_Z      0
+
+/* CFG_REG_A => [comp_temp_en, reboot, soft_rst, lp, odr<1:0>, md<1:0>] */
+/*      temp compensation, high resolution, 50 Hz, continuous mode */
+/*      => 50 Hz refills the heading filter in 200 ms */
+#define SENSORCFG_MAG_CFG_A         0x88
+
+/* CFG_REG_B => [0, 0, 0, off_canc_one_shot, int_on_dataoff, set_freq, off_canc, lpf] */
+/*      lpf => bandwidth ODR/4 instead of ODR/2 */
+/*      off_canc => set/reset pulse each sample cancels the sensor's own offset */
+#define SENSORCFG_MAG_LPF           0x01
+#define SENSORCFG_MAG_OFF_CANC      0x02
+#define SENSORCFG_MAG_CFG_B         (SENSORCFG_MAG_OFF_CANC | SENSORCFG_MAG_LPF)
+
+/* Calibration profile => stored at EE_ADDR_SENSORCFG */
+struct SENSORCFG_Profile {
+    unsigned char magic;
+    unsigned char checksum;         // EEPROM_checksum() of the rest
+    int8_t accelOffset[3];          // OFSX, OFSY, OFSZ
+    unsigned char accelBwRate;      // BW_RATE
+    int16_t magOffset[3];           // OFFSET_X/Y/Z_REG
+    unsigned char magCfgA;          // CFG_REG_A
+    unsigned char magCfgB;          // CFG_REG_B
+};
+
+/**
+ * @brief   Load the calibration profile from EEPROM, or the defaults
+ *          above if none has been stored.
+ *          => call before initAccel() and Mag_Initialize() <=
+ * @param   NULL
+ * @return  1 if the profile came from EEPROM, 0 if defaults are used
+ */
+int initSensorConfig(void);
+
+/**
+ * @brief   Program the ADXL343 offset and data rate registers.
+ *          Called by initAccel() while the sensor is in standby.
+ * @param   NULL
+ * @return  0 if successful, -1 if a write collided
+ */
+signed char SENSORCFG_applyAccel(void);
+
+/**
+ * @brief   Program the LIS2MDL hard-iron offset and configuration
+ *          registers. Called by Mag_Initialize(), CFG_REG_A last since
+ *          it starts continuous measurement.
+ * @param   NULL
+ * @return  0 if successful, -1 if a write collided
+ */
+signed char SENSORCFG_applyMag(void);
+
+/**
+ * @brief   Copy the profile in use.
+ * @param   profile: filled with the current profile
+ * @return  NULL
+ */
+void SENSORCFG_getProfile(struct SENSORCFG_Profile *profile);
+
+/**
+ * @brief   Store a new profile in EEPROM and program both sensors
+ *          with it, e.g. after a calibration run.
+ * @param   profile: new profile, magic and checksum are filled in
+ * @return  0 if successful, -1 if a write collided
+ */
+signed char SENSORCFG_setProfile(const struct SENSORCFG_Profile *profile);
+
+#endif /* _SENSORCFG_H_ */
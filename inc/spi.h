@@ -11,6 +11,8 @@
 #ifndef _SPI_H_
 #define _SPI_H_
 
+#include <stdint.h> // uint16_t, uint32_t
+
 /* Serial Port Pins */
 #define _SPI_SDI TRISCbits.TRISC4  /* serial data in */
 #define _SPI_SDO TRISCbits.TRISC5  /* serial data out */
@@ -22,6 +24,43 @@
 /* macros to choose slave */
 #define ACCELEROMETER   1
 #define MAGNETOMETER    2
+#define SPI_NUM_SLAVES  2
+
+/* SSPM3:SSPM0 master clock => 2 MHz, 500 kHz, 125 kHz at 8 MHz */
+/* every slave starts at SPI_FOSC_64 until SPI_tune() has run on it */
+#define SPI_FOSC_4      0x00
+#define SPI_FOSC_16     0x01
+#define SPI_FOSC_64     0x02
+
+/* ID reads per clock in SPI_tune() => all must match */
+#define SPI_TUNE_READS  16
+
+/* busy time is counted in Timer1 ticks => 4 us, see initRTC() */
+#define SPI_TICKS_PER_MS 250
+
+/* Transactions waiting or on the bus => see SPI_submit() */
+#define SPI_QUEUE_LEN   4
+
+/* Queued transaction: txLen bytes out, then rxLen bytes in (0x00 sent) */
+/* => must stay in place until done is set, txLen + rxLen <= 255 */
+struct SPI_Transaction {
+    unsigned char slave;        // ACCELEROMETER or MAGNETOMETER
+    const uint8_t *tx;
+    unsigned char txLen;
+    uint8_t *rx;
+    unsigned char rxLen;
+    volatile unsigned char done;    // set when ~CS is back high
+    void (*complete)(struct SPI_Transaction *t);    // NULL or called at done
+};
+
+/* Transfer counters of one slave */
+struct SPI_Stats {
+    uint32_t bytes;             // bytes clocked while selected
+    uint32_t busyTicks;         // time selected, Timer1 ticks
+    uint16_t transactions;      // select/unselect pairs, wraps
+    unsigned char speed;        // SPI_FOSC_* in use
+    unsigned char passed;       // bit n set => SSPM n read the ID back
+};
 
 /* in order to use built-in delay functions defined in 'xc.h' */
 #define _XTAL_FREQ 8000000
@@ -54,7 +93,12 @@ void initSPI(void);
  *          ~CS low. Should be set at start of transmission for the duration
  *          of the transmission. Must be unselected at the end of the
  *          transmission. => see _SPI_unselectSlave()
+ *          A queued transaction on the bus is finished first (polled), the
+ *          rest of the queue waits until unselect. Switches the SPI clock
+ *          to the slave's speed while every ~CS is still high.
  *          => DOES NOT configure slave device <=
+ *          => low priority interrupts (the sensor data-ready handlers,
+ *             which use SPI themselves) are held off until unselect <=
  * @param   slave: accelerometer or magnetometer
  * @return  NULL
  */
@@ -62,11 +106,22 @@ void _SPI_selectSlave(int slave);
 
 /**
  * @brief   Unselects slave. Should be used at the end of transmission.
+ *          Starts the next queued transaction, if any, then restores the
+ *          low priority interrupt enable.
  * @param   slave: accelerometer or magnetometer
  * @return  NULL
  */
 void _SPI_unselectSlave(int slave);
 
+/**
+ * @brief   Pulse ~CS of the selected slave high and low again to start a
+ *          new command, without giving the bus up in between.
+ *          => only between _SPI_selectSlave() and _SPI_unselectSlave() <=
+ * @param   slave: accelerometer or magnetometer, as selected
+ * @return  NULL
+ */
+void _SPI_reselectSlave(int slave);
+
 /**
  * @brief   Transmit 1 byte of data to already selected slave device.
  *          => source: https://openlabpro.com/guide/spi-module-in-pic18f4550/
@@ -83,4 +138,68 @@ signed char _SPI_write(unsigned char data_out);
  */
 unsigned char _SPI_read(void);
 
+/**
+ * @brief   Self-check: read the slave's ID register SPI_TUNE_READS times
+ *          at each clock, then keep the fastest clock that read it back
+ *          every time. Run before the slave's data-ready interrupt is
+ *          enabled, the clock changes between reads.
+ * @param   slave: accelerometer or magnetometer
+ * @param   readCmd: first byte that reads the ID register
+ * @param   expected: ID value
+ * @return  SPI_FOSC_* kept, -1 if no clock read the ID (left at SPI_FOSC_64)
+ */
+signed char SPI_tune(int slave, unsigned char readCmd, unsigned char expected);
+
+/**
+ * @brief   Copy the transfer counters of a slave.
+ * @param   slave: accelerometer or magnetometer
+ * @param   stats: filled with the counters
+ * @return  NULL
+ */
+void SPI_getStats(int slave, struct SPI_Stats *stats);
+
+/**
+ * @brief   Zero the byte, time and transaction counters of a slave.
+ * @param   slave: accelerometer or magnetometer
+ * @return  NULL
+ */
+void SPI_resetStats(int slave);
+
+/**
+ * @brief   Throughput while the slave is selected (command bytes, ~CS and
+ *          loop overhead included). Counts only once initRTC() has
+ *          started Timer1.
+ * @param   slave: accelerometer or magnetometer
+ * @return  bytes per ms, 0 before any time was counted
+ */
+uint16_t SPI_getThroughput(int slave);
+
+/**
+ * @brief   Queue a transaction, driven byte by byte from SPI_ISR(). Returns
+ *          at once; done is set (and complete called) with ~CS back high.
+ *          => complete runs at low priority, or inside _SPI_selectSlave()
+ *             / SPI_flush() with GIEL 0: keep it short, it may submit
+ *             but must not select a slave itself <=
+ * @param   t: transaction, owned by the queue until done
+ * @return  0 if queued, -1 if the queue is full or t is invalid
+ */
+signed char SPI_submit(struct SPI_Transaction *t);
+
+/**
+ * @brief   Wait (polled) until every queued transaction is done. Not to be
+ *          called with a slave selected.
+ * @param   NULL
+ * @return  NULL
+ */
+void SPI_flush(void);
+
+/**
+ * @brief   SSP interrupt handler, low priority => moves the transaction
+ *          at the head of the queue on by a byte. At Fosc/4 it polls to
+ *          the end of the queue, a byte is shorter than the ISR entry.
+ * @param   NULL
+ * @return  NULL
+ */
+void SPI_ISR(void);
+
 #endif /* _SPI_H_*/
@@ -1,6 +1,9 @@
 /**
  * @file   uart.h
  * @brief  Functions for UART transmission & receival.
+ *         => RX and TX are interrupt driven: bytes are moved between
+ *            the hardware and two ring buffers in UART_ISR() so callers
+ *            never wait on RCIF/TXIF themselves <=
  * @author Carter Bordeleau
  * @date   04/23/2022
  */
@@ -13,12 +16,98 @@
 #include <string.h>
 #include <stdlib.h>
 
+#ifndef _XTAL_FREQ
+#define _XTAL_FREQ 8000000
+#endif
+
+// rate set by UART_RX_Init()
+#define UART_DEFAULT_BAUD 9600UL
+
+// ring buffer sizes, must be powers of 2
+// => RX indices are 16-bit, TX indices 8-bit so TX no larger than 128
+#define UART_RX_SIZE 256    // > one second of RMC + GGA (~150 bytes)
+#define UART_TX_SIZE 64
+
+// counters kept by the driver
+struct UART_Stats {
+    unsigned int rx_dropped;        // bytes lost because the RX ring was full
+    unsigned int rx_overruns;       // hardware overrun (OERR) events
+    unsigned int tx_dropped;        // bytes rejected because the TX ring was full
+    unsigned int rx_high_water;     // most bytes ever waiting in the RX ring
+    unsigned char tx_high_water;    // most bytes ever waiting in the TX ring
+};
+
 // fn declarations
 char UART_Read_char(void);
 void UART_RX_Init(void);
 void UART_send_char(char );
 void UART_send_str(const char *);
 
-char UART_buffer[100];
+/**
+ * @brief   Get the next received byte if there is one. Never blocks.
+ * @param   c: where to store the byte
+ * @return  1 if a byte was read, 0 if the RX ring is empty
+ */
+int UART_try_read_char(char *c);
+
+/**
+ * @brief   Queue a byte for transmission if there is room. Never blocks.
+ * @param   c: byte to send
+ * @return  1 if queued, 0 if the TX ring is full (counted in tx_dropped)
+ */
+int UART_try_send_char(char c);
+
+/**
+ * @brief   Queue as much of a string as fits in the TX ring. Never blocks.
+ * @param   str: null terminated string
+ * @return  number of chars queued
+ */
+int UART_try_send_str(const char *str);
+
+/**
+ * @brief   Change the baud rate. Uses the 16-bit baud rate generator
+ *          (BRG16 = 1, BRGH = 1 => baud = Fosc / (4 * (SPBRGH:SPBRG + 1)))
+ *          so the divisor error at 8 MHz is +0.16% at 9600 and 38400 and
+ *          -0.79% at 57600; 115200 would be +2.1% and is not reliable.
+ *          Waits for queued TX bytes to go out at the old rate first.
+ * @param   baud: bits per second
+ * @return  NULL
+ */
+void UART_set_baud(unsigned long baud);
+
+/**
+ * @brief   Current baud rate.
+ * @param   NULL
+ * @return  bits per second
+ */
+unsigned long UART_get_baud(void);
+
+/**
+ * @brief   Whether everything queued has been shifted out.
+ * @param   NULL
+ * @return  1 if the TX ring and shift register are empty, 0 if not
+ */
+int UART_tx_idle(void);
+
+/**
+ * @brief   Number of received bytes waiting to be read.
+ * @param   NULL
+ * @return  bytes in the RX ring
+ */
+unsigned int UART_rx_count(void);
+
+/**
+ * @brief   Copy the driver counters.
+ * @param   stats: destination
+ * @return  NULL
+ */
+void UART_get_stats(struct UART_Stats *stats);
+
+/**
+ * @brief   RCIF/TXIF handler, must be called from the interrupt routine.
+ * @param   NULL
+ * @return  NULL
+ */
+void UART_ISR(void);
 
 #endif	/* UART_H */
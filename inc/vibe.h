@@ -0,0 +1,94 @@
+/**
+ * @file    vibe.h
+ * @author  Mustafa Siddiqui
+ * @brief   Header file for the vibration monitor: every ADXL343 sample
+ *          the FIFO drain reads is fed in, and over blocks of VIBE_N
+ *          samples the monitor measures the RMS of the dynamic
+ *          acceleration and, with a Goertzel filter per frequency, the
+ *          amplitude near the structure's resonance. When either stays
+ *          above its threshold the tracker is asked to stow (panel flat)
+ *          until the wind has died down.
+ *          => per sample: 3 Goertzel steps and 3 axes of sums, one
+ *             16x32 multiply each; per block: 1 square root <=
+ *          => thresholds are starting points, tune them on site <=
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _VIBE_H_
+#define _VIBE_H_
+
+#include <stdint.h> // int16_t, uint16_t
+
+/* Samples per block => 0.64 sec at 100 Hz, 1.6 Hz resolution */
+#define VIBE_N              64
+
+/* Samples are taken >> 4 => 1 unit = 1/512 g (~2 mg) at +-4g left */
+/* justified, and clamped to +-0.5 g around the block mean */
+#define VIBE_SHIFT          4
+#define VIBE_CLAMP          256
+
+/* Axis the Goertzel filters run on => z, the panel normal when flat */
+#define VIBE_AXIS           2
+
+/* Goertzel frequencies around the resonance at the 100 Hz ODR */
+/* => cos and sin of 2 pi f / 100 in Q12 */
+#define VIBE_NUM_BINS       3
+#define VIBE_BIN_HZ         {2, 3, 4}
+#define VIBE_BIN_COS        {4064, 4023, 3967}
+#define VIBE_BIN_SIN        {513, 768, 1019}
+
+/* Stow when for VIBE_TRIP_BLOCKS blocks in a row */
+/*      the total RMS is above VIBE_RMS_STOW (26 ~ 0.05 g), or */
+/*      the largest resonance amplitude is above VIBE_RES_STOW (15 ~ 0.03 g) */
+/* and stay stowed until VIBE_CLEAR_BLOCKS quiet blocks (~10 min) */
+#define VIBE_RMS_STOW       26
+#define VIBE_RES_STOW       15
+#define VIBE_TRIP_BLOCKS    2
+#define VIBE_CLEAR_BLOCKS   940
+
+/* Result of the last block */
+struct VIBE_Stats {
+    uint16_t rms;                   // total RMS, units of 1/512 g
+    uint16_t amp[VIBE_NUM_BINS];    // amplitude per frequency, 1/512 g
+    unsigned char dominant;         // index of the largest amp
+    unsigned char windy;            // stow requested
+    uint16_t blocks;                // blocks analysed
+};
+
+/**
+ * @brief   Start over: no blocks analysed, not windy.
+ * @param   NULL
+ * @return  NULL
+ */
+void initVibe(void);
+
+/**
+ * @brief   Feed one accelerometer sample. Called by _ACCEL_drainFIFO()
+ *          for every FIFO entry, from ACCEL_ISR() or from the timeout
+ *          path of _ACCEL_getAvgReading(); both run with GIEL = 0, so
+ *          calls never overlap. The block is analysed when its last
+ *          sample comes in.
+ * @param   sample: [x, y, z] reading
+ * @return  NULL
+ */
+void VIBE_push(const int16_t *sample);
+
+/**
+ * @brief   Stow requested => set after VIBE_TRIP_BLOCKS bad blocks,
+ *          cleared after VIBE_CLEAR_BLOCKS quiet ones.
+ * @param   NULL
+ * @return  1 if the tracker should be (or stay) stowed, 0 if not
+ */
+int VIBE_isWindy(void);
+
+/**
+ * @brief   Copy the result of the last block.
+ * @param   stats: filled with the result
+ * @return  NULL
+ */
+void VIBE_getStats(struct VIBE_Stats *stats);
+
+#endif /* _VIBE_H_ */
@@ -9,78 +9,48 @@
  */
 
 #include "../inc/accel.h"
-#include "../inc/spi.h"     // _SPI_*() functions
+#include "../inc/spi.h"     // SPI_tune()
+#include "../inc/regbus.h"  // REGBUS_*()
+#include "../inc/rtc.h"     // RTC_getTicks()
+#include "../inc/sensorcfg.h" // SENSORCFG_applyAccel()
+#include "../inc/fixmath.h" // FX_atan2(), FX_magnitude()
+#include "../inc/filter.h"  // FILTER_*()
+#include "../inc/vibe.h"    // initVibe(), VIBE_push()
 //-//
 #include <xc.h>
 #include <stdio.h>  // sprintf()
 #include <string.h> // memset()
-#include <math.h>   // sqrt()
 
 #define VERTICAL_ANGLE_OFFSET -5 //offset due to unlevel sensor
 
-/* create first data byte for SDI line for accelerometer */
-unsigned char _ACCEL_createDataByte1(int RW, int MB, unsigned char addr) {
-    unsigned char dataByte1 = 0x0;
-    dataByte1 |= addr;
+/* filled by ACCEL_ISR() each time the FIFO reaches its watermark */
+static volatile struct SensorSample slot;
 
-    // set read/write bit
-    if (RW == 1)
-        SET(dataByte1, 7);
-    else
-        CLEAR(dataByte1, 7);
+/* streaming filters fed by ACCEL_ISR() => median of 3, moving average */
+static struct FILTER_Median median[NUM_AXIS];
+static struct FILTER_Avg average[NUM_AXIS];
+static volatile struct SensorSample filtered;
 
-    // set multiple byte transmission bit
-    if (MB == 1)
-        SET(dataByte1, 6);
-    else
-        CLEAR(dataByte1, 6);
+/* raw blocks for the settle detector */
+static struct FILTER_Avg motion[NUM_AXIS];
+static volatile uint32_t motionVar;
 
-    return dataByte1;
-}
+/* [R/W, MB, A5-A0] => see regbus.h */
+static const struct REGBUS_Device bus = {ACCELEROMETER, 0x80, 0x40, 0x3F};
 
 /* write to register on accelerometer */
 signed char _ACCEL_writeToRegister(unsigned char addr, unsigned char data) {
-    // first byte consists of R/W, MB, and address bits (of the register to write to)
-    // latter byte is data to be written
-    unsigned char dataByte_1 = _ACCEL_createDataByte1(0, 0, addr);
-    unsigned char dataByte_2 = data;
-
-    // start transmission by pulling ~CS low
-    _SPI_selectSlave(ACCELEROMETER);
-    
-    signed char status1 = _SPI_write(dataByte_1);
-    signed char status2 = _SPI_write(dataByte_2);
-
-    // end transmisson by setting ~CS high
-    _SPI_unselectSlave(ACCELEROMETER);
-    
-    // write not successful; collision occured somewhere
-    if ((status1 != 0) || (status2 != 0)) {
-        return -1;
-    }
-
-    return 0;
+    return REGBUS_write(&bus, addr, data);
 }
 
 /* read from register on accelerometer */
 unsigned char _ACCEL_readFromRegister(unsigned char addr) {
-    // to store received data
-    unsigned char data = 0x00;
-
-    // first byte consists of R/W, MB, and address of register to read
-    unsigned char dataByte_1 = _ACCEL_createDataByte1(1, 0, addr);
+    return REGBUS_read(&bus, addr);
+}
 
-    // start transmission by pulling ~CS low
-    _SPI_selectSlave(ACCELEROMETER);
-    
-    // write on MOSI line & receive on MISO line
-    _SPI_write(dataByte_1);
-    data = _SPI_read();
-    
-    // end transmission by setting ~CS high
-    _SPI_unselectSlave(ACCELEROMETER); 
-    
-    return data;
+/* read consecutive registers on accelerometer in one transaction */
+void _ACCEL_readRegisters(unsigned char addr, uint8_t *data, unsigned char len) {
+    REGBUS_readBlock(&bus, addr, data, len);
 }
 
 /* get device ID */
@@ -90,12 +60,16 @@ unsigned char _ACCEL_getDeviceID(void) {
 
 /* get current x,y,z axis readings */
 void _ACCEL_getCurrentReading(int16_t *sensorData) {
-    uint8_t xVal_0 = _ACCEL_readFromRegister(_ADDR_DATA_X0);
-    uint8_t xVal_1 = _ACCEL_readFromRegister(_ADDR_DATA_X1);
-    uint8_t yVal_0 = _ACCEL_readFromRegister(_ADDR_DATA_Y0);
-    uint8_t yVal_1 = _ACCEL_readFromRegister(_ADDR_DATA_Y1);
-    uint8_t zVal_0 = _ACCEL_readFromRegister(_ADDR_DATA_Z0);
-    uint8_t zVal_1 = _ACCEL_readFromRegister(_ADDR_DATA_Z1);
+    // DATAX0..DATAZ1 in one burst => all axes come from the same sample
+    // (the sensor holds its data registers while ~CS is low)
+    uint8_t raw[6];
+    _ACCEL_readRegisters(_ADDR_DATA_X0, raw, sizeof(raw));
+    uint8_t xVal_0 = raw[0];
+    uint8_t xVal_1 = raw[1];
+    uint8_t yVal_0 = raw[2];
+    uint8_t yVal_1 = raw[3];
+    uint8_t zVal_0 = raw[4];
+    uint8_t zVal_1 = raw[5];
 
     // combine high and low values into one number
     // bits represent signed 2's complement format
@@ -106,34 +80,174 @@ void _ACCEL_getCurrentReading(int16_t *sensorData) {
     int16_t z = (zVal_1 << 8) | zVal_0;
 
     // populate var
-    memset(sensorData, 0, NUM_AXIS * sizeof(sensorData[0]));
-    sensorData[0] = x + xAxisOffset;
-    sensorData[1] = y + yAxisOffset;
-    sensorData[2] = z + zAxisOffset;
+    // => offsets are added by the sensor, see SENSORCFG_applyAccel()
+    sensorData[0] = x;
+    sensorData[1] = y;
+    sensorData[2] = z;
 }
 
-/* get average x,y,z readings from sensor */
-void _ACCEL_getAvgReading(int32_t *avgData) {
-    memset(avgData, 0, NUM_AXIS * sizeof(avgData[0]));
-
-    // get NUM_READINGS amount of readings and average
-    // O(NUM_READINGS * NUM_AXIS) = constant time
+/* pop every waiting FIFO entry and average them */
+unsigned char _ACCEL_drainFIFO(int16_t *avgData) {
+    int32_t sum[NUM_AXIS] = {0};
     int16_t sensorReading[NUM_AXIS] = {0};
-    for (int i = 0; i < NUM_READINGS; i++) {
+
+    unsigned char entries = _ACCEL_readFromRegister(_ADDR_FIFO_STATUS) & ACCEL_FIFO_ENTRIES;
+    if (entries == 0) {
+        return 0;
+    }
+
+    // every read of DATAX0..DATAZ1 pops one FIFO entry
+    // => one transaction each, not a REGBUS_batch(): the next pop must
+    //    wait 5 us after ~CS goes high
+    // O(entries * NUM_AXIS), entries <= 33
+    for (unsigned char i = 0; i < entries; i++) {
         _ACCEL_getCurrentReading(sensorReading);
+        VIBE_push(sensorReading);   // needs every sample, not the average
         for (int j = 0; j < NUM_AXIS; j++) {
-            avgData[j] += sensorReading[j];
+            sum[j] += sensorReading[j];
         }
     }
 
     // O(NUM_AXIS) = constant time
     for (int c = 0; c < NUM_AXIS; c++) {
-        avgData[c] /= NUM_READINGS;
+        avgData[c] = (int16_t)(sum[c] / entries);
+    }
+    return entries;
+}
+
+/* get average x,y,z readings from sensor */
+void _ACCEL_getAvgReading(int32_t *avgData) {
+    // keeps the sequence number of the last block handed out
+    static struct SensorSample sample;
+
+    // wait for a block the watermark interrupt has not handed out yet
+    int ms = 0;
+    while (!ACCEL_getSample(&sample) && ms < ACCEL_FIFO_TIMEOUT_MS) {
+        __delay_ms(1);
+        ms++;
+    }
+    
+    // a missed INT1 edge leaves the line high with no new edge to come
+    // => drain here, which lets INT1 fall and rise again
+    if (ms >= ACCEL_FIFO_TIMEOUT_MS) {
+        // ACCEL_ISR() drains at low priority => keep it out until the
+        // FIFO is empty, or both pop entries and feed VIBE_push()
+        // (the SPI access polls with GIEL = 0 already, see spi.c)
+        unsigned char giel = INTCONbits.GIEL;
+        INTCONbits.GIEL = 0;
+        if (!_ACCEL_drainFIFO(sample.axis)) {
+            // FIFO not running => just the data registers
+            _ACCEL_getCurrentReading(sample.axis);
+        }
+        INTCONbits.GIEL = giel;
+    }
+
+    for (int c = 0; c < NUM_AXIS; c++) {
+        avgData[c] = sample.axis[c];
+    }
+}
+
+/* copy the latest block, 1 if it is newer than the one in *sample */
+int ACCEL_getSample(struct SensorSample *sample) {
+    // the slot is written at low priority
+    unsigned char giel = INTCONbits.GIEL;
+    INTCONbits.GIEL = 0;
+    int fresh = (slot.seq != 0 && slot.seq != sample->seq);
+    if (fresh) {
+        memcpy(sample, (const void *)&slot, sizeof(*sample));
+    }
+    INTCONbits.GIEL = giel;
+    return fresh;
+}
+
+/* copy the filtered state, 1 if there is one */
+int ACCEL_getFiltered(struct SensorSample *sample) {
+    // written at low priority
+    unsigned char giel = INTCONbits.GIEL;
+    INTCONbits.GIEL = 0;
+    memcpy(sample, (const void *)&filtered, sizeof(*sample));
+    INTCONbits.GIEL = giel;
+    return sample->seq != 0;
+}
+
+/* FIFO watermark reached on INT1 => average the block into the slot */
+void ACCEL_ISR(void) {
+    int16_t avg[NUM_AXIS];
+
+    if (!(INTCON3bits.INT1IE && INTCON3bits.INT1IF)) {
+        return;
+    }
+    INTCON3bits.INT1IF = 0;
+
+    // newest sample arrived just now
+    uint32_t ticks = RTC_getTicks();
+    unsigned char entries = _ACCEL_drainFIFO(avg);
+    if (entries == 0) {
+        return;
+    }
+
+    for (int c = 0; c < NUM_AXIS; c++) {
+        slot.axis[c] = avg[c];
+    }
+    slot.ticks = ticks;
+    slot.count = entries;
+    slot.seq = SAMPLE_NEXT_SEQ(slot.seq);
+
+    // O(NUM_AXIS) => a spike in one block is dropped by the median
+    for (int c = 0; c < NUM_AXIS; c++) {
+        FILTER_avgPush(&average[c], FILTER_medianPush(&median[c], avg[c]));
+        filtered.axis[c] = FILTER_avgGet(&average[c]);
+    }
+    filtered.ticks = ticks;
+    filtered.count = average[0].count;
+    filtered.seq = slot.seq;
+
+    // O(NUM_AXIS * ACCEL_SETTLE_LEN) => unfiltered, a swing must show
+    uint32_t var = 0;
+    for (int c = 0; c < NUM_AXIS; c++) {
+        FILTER_avgPush(&motion[c], avg[c]);
+        uint32_t v = FILTER_avgVariance(&motion[c]);
+        var = (var > UINT32_MAX - v) ? UINT32_MAX : var + v;
+    }
+    motionVar = (motion[0].count < ACCEL_SETTLE_LEN) ? UINT32_MAX : var;
+}
+
+/* motion over the last ACCEL_SETTLE_LEN blocks */
+uint32_t ACCEL_getMotion(void) {
+    // 32-bit => not atomic on the PIC18
+    unsigned char giel = INTCONbits.GIEL;
+    INTCONbits.GIEL = 0;
+    uint32_t var = motionVar;
+    INTCONbits.GIEL = giel;
+    return var;
+}
+
+/* wait for a full window of still blocks taken after the call */
+int ACCEL_waitSettled(void (*idle)(void)) {
+    struct SensorSample sample;
+    ACCEL_getFiltered(&sample);
+    uint16_t start = sample.seq;
+
+    for (int ms = 0; ms < ACCEL_SETTLE_TIMEOUT_MS; ms++) {
+        ACCEL_getFiltered(&sample);
+        // seq skips 0 on wrap => off by one once every 55 minutes, harmless
+        uint16_t blocks = sample.seq - start;
+        if (blocks >= ACCEL_SETTLE_LEN && ACCEL_getMotion() < ACCEL_SETTLE_VAR) {
+            return ms;
+        }
+        if (idle) {
+            idle();
+        }
+        __delay_ms(1);
     }
+    return -1;
 }
 
 /* initialize accelerometer module */
 int initAccel(void) {
+    // fastest SPI clock that reads DEVID back => before INT1 is enabled
+    SPI_tune(ACCELEROMETER, REGBUS_command(&bus, _ADDR_DEVID, REGBUS_READ, 1), DEVID);
+    
     // => [self_test, spi, int_invert, 0, full_res, justify, range<1:0>]
     //      spi mode: 3-wire (1), 4-wire (0)
     //      resolution: full_res (1), 10-bit mode (0)
@@ -141,11 +255,44 @@ int initAccel(void) {
     //      range: 2g
     _ACCEL_writeToRegister(_ADDR_DATA_FORMAT, 0x05);
     
+    // offset registers and output data rate from the calibration profile
+    // => still in standby, so the FIFO only ever holds corrected samples
+    SENSORCFG_applyAccel();
+    
+    // FIFO => [fifo_mode<1:0>, trigger, samples<4:0>]
+    //      stream mode, watermark interrupt at ACCEL_FIFO_WATERMARK samples
+    //      routed to INT1 (INT_MAP bit = 0), INT1 is active high
+    //      => in one batch, the bus is taken once
+    uint8_t intOff = 0x00;
+    uint8_t fifoCtl = ACCEL_FIFO_STREAM | ACCEL_FIFO_WATERMARK;
+    uint8_t intMap = 0x00;
+    uint8_t intOn = ACCEL_INT_WATERMARK;
+    const struct REGBUS_Op setup[] = {
+        {_ADDR_INT_ENABLE, REGBUS_WRITE, &intOff, 1},
+        {_ADDR_FIFO_CTL, REGBUS_WRITE, &fifoCtl, 1},
+        {_ADDR_INT_MAP, REGBUS_WRITE, &intMap, 1},
+        {_ADDR_INT_ENABLE, REGBUS_WRITE, &intOn, 1},
+    };
+    REGBUS_batch(&bus, setup, sizeof(setup) / sizeof(setup[0]));
+    
+    // INT1 pin => RB1/INT1 on the rising edge, low priority (uses SPI)
+    memset((void *)&slot, 0, sizeof(slot));
+    memset((void *)&filtered, 0, sizeof(filtered));
+    for (int c = 0; c < NUM_AXIS; c++) {
+        FILTER_medianInit(&median[c]);
+        FILTER_avgInit(&average[c], ACCEL_FILTER_LEN);
+        FILTER_avgInit(&motion[c], ACCEL_SETTLE_LEN);
+    }
+    motionVar = UINT32_MAX;
+    initVibe();
+    ACCEL_INT1_PIN = 1;             // input
+    INTCON2bits.INTEDG1 = 1;
+    INTCON3bits.INT1IP = 0;
+    INTCON3bits.INT1IF = 0;
+    INTCON3bits.INT1IE = 1;
+    
     // enable measurement mode (set bit D3)
     _ACCEL_writeToRegister(_ADDR_POWER_CTL, 0x08);
-
-    // select rate_bits in bw_rate to set output data rate
-    // => default value is 0x0A which translates to 100 Hz, let's keep it at that atm
     
     // return 0 if incorrect device id
     if (_ACCEL_getDeviceID() != DEVID) 
@@ -161,19 +308,41 @@ int getCurrentZenith(void) {
     // going to be the same regardless
     // format: [x, y, z]
     int32_t sensorData[NUM_AXIS] = {0};
-    _ACCEL_getAvgReading(sensorData);
+    struct SensorSample sample;
+    if (ACCEL_getFiltered(&sample)) {
+        for (int c = 0; c < NUM_AXIS; c++) {
+            sensorData[c] = sample.axis[c];
+        }
+    } else {
+        // no watermark interrupt yet => wait for a block
+        _ACCEL_getAvgReading(sensorData);
+    }
     
-    // V = sqrt(Vx^2 + Vy^2 + Vz^2)
-    float vector = sqrt(SQUARE(sensorData[0]) + SQUARE(sensorData[1]) + SQUARE(sensorData[2]));
+    // averages of int16 readings => each axis fits int16
+    int16_t gravity[NUM_AXIS];
+    for (int c = 0; c < NUM_AXIS; c++) {
+        gravity[c] = (int16_t)sensorData[c];
+    }
+    return ACCEL_Zenith(gravity);
+}
 
+/* zenith angle of a gravity vector */
+int ACCEL_Zenith(const int16_t *sensorData) {
     // calculate the zenith angle (angle between vector and the vertical axis)
     // according to the orientation of the sensor in our device structure
-    float angle = acos(((float)sensorData[1]) / vector);
+    // => acos(Vy / |V|) as atan2(sqrt(Vx^2 + Vz^2), Vy): no division by
+    //    |V| and full resolution when y is near vertical
+    uint16_t vxz = FX_magnitude(sensorData[0], 0, sensorData[2]);
+    int angle = FX_BAM_TO_DEG(FX_atan2(vxz, sensorData[1]));
+    
+    // vxz >= 0 => [0, 180] deg, where 180 comes back as -180
+    if (angle < 0)
+        angle += 360;
 
     // return integer value of angle in degrees
     // when sensor horizontal: angle = 0
     // when sensor vertical: angle = 
     //    1.  y pointing down = -90
     //    2.  y pointing up = +90
-    return 90 - (int)(angle * (180/M_PI));
+    return 90 - angle;
 }
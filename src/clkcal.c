@@ -0,0 +1,151 @@
+/**
+ * @file    clkcal.c
+ * @author  Mustafa Siddiqui
+ * @brief   Function definitions for 1PPS oscillator calibration.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "../inc/clkcal.h"
+#include "../inc/rtc.h"     // RTC_getTicks(), RTC_setTicksPerSecond()
+//-//
+#include <xc.h>
+#include <stdlib.h>         // labs()
+
+/* Timer1 ticks per PPS allowed around nominal */
+#define MAX_TICK_ERROR  ((int32_t)(RTC_NOMINAL_TPS / 1000) * CLKCAL_MAX_ERROR_PPM / 1000)
+
+/* Instruction cycles per Timer1 tick => 1:8 prescaler */
+#define CYCLES_PER_TICK 8
+
+/* filled by the ISR */
+static volatile uint32_t lastEdge;
+static volatile unsigned char haveEdge;
+static volatile unsigned char edges;
+static volatile uint32_t tickSum;
+static volatile uint32_t readySum;      // sum of CLKCAL_AVG_EDGES periods
+static volatile unsigned char ready;
+
+/* control loop state */
+static int32_t errorPpm;
+static uint32_t cyclesPerPps;
+static int32_t stepPpm = CLKCAL_DEFAULT_STEP_PPM;
+static int32_t errorBeforeStep;
+static unsigned char stepPending;       // OSCTUNE changed, next result measures the step
+static unsigned char locked;
+
+/* configure PPS input */
+void initClockCal(void) {
+    CLKCAL_PPS_PIN = 1;             // input
+    INTCON2bits.INTEDG0 = 1;        // rising edge
+    INTCONbits.INT0IF = 0;
+    INTCONbits.INT0IE = 1;
+}
+
+/* timestamp PPS edge */
+void CLKCAL_ISR(void) {
+    if (!(INTCONbits.INT0IE && INTCONbits.INT0IF)) {
+        return;
+    }
+    INTCONbits.INT0IF = 0;
+    
+    uint32_t now = RTC_getTicks();
+    uint32_t period = now - lastEdge;
+    lastEdge = now;
+    
+    // start over after a glitch or missing pulses (no fix => no PPS)
+    if (!haveEdge || labs((int32_t)(period - RTC_NOMINAL_TPS)) > MAX_TICK_ERROR) {
+        haveEdge = 1;
+        edges = 0;
+        tickSum = 0;
+        return;
+    }
+    
+    tickSum += period;
+    if (++edges == CLKCAL_AVG_EDGES) {
+        readySum = tickSum;
+        ready = 1;
+        edges = 0;
+        tickSum = 0;
+    }
+}
+
+/* step OSCTUNE by +-1 within its 5-bit two's complement range */
+/* => 0 if it is already at the end of the range */
+static int CLKCAL_stepTune(signed char dir) {
+    signed char tune = (signed char)(OSCTUNE << 3) >> 3;   // sign-extend TUN<4:0>
+    tune += dir;
+    if (tune > 15 || tune < -16) {
+        return 0;
+    }
+    OSCTUNE = (OSCTUNE & 0xE0) | ((unsigned char)tune & 0x1F);
+    return 1;
+}
+
+/* one control loop step per averaged measurement */
+int CLKCAL_service(void) {
+    if (!ready) {
+        return 0;
+    }
+    
+    unsigned char ie = INTCONbits.INT0IE;
+    INTCONbits.INT0IE = 0;
+    uint32_t sum = readySum;
+    ready = 0;
+    INTCONbits.INT0IE = ie;
+    
+    // error = (sum - n*nominal) / (n*nominal) * 1e6 => 1e6/250000 = 4
+    errorPpm = (int32_t)(sum - CLKCAL_AVG_EDGES * RTC_NOMINAL_TPS) * 4 / CLKCAL_AVG_EDGES;
+    cyclesPerPps = sum / CLKCAL_AVG_EDGES * CYCLES_PER_TICK;
+    
+    // Timer1 runs off the same clock => the RTC counts measured ticks
+    RTC_setTicksPerSecond((sum + CLKCAL_AVG_EDGES / 2) / CLKCAL_AVG_EDGES);
+    
+    // learn the real OSCTUNE step size from the last change
+    if (stepPending) {
+        int32_t step = labs(errorBeforeStep - errorPpm);
+        if (step > 0) {
+            stepPpm = (stepPpm + step) / 2;
+        }
+        stepPending = 0;
+    }
+    
+    locked = (labs(errorPpm) <= stepPpm / 2);
+    if (locked) {
+        return 0;
+    }
+    
+    // running fast => lower the frequency
+    // => nothing to learn from (or discard) if the trim is at its rail
+    if (!CLKCAL_stepTune(errorPpm > 0 ? -1 : 1)) {
+        return 0;
+    }
+    errorBeforeStep = errorPpm;
+    stepPending = 1;
+    
+    // discard the period the change landed in
+    INTCONbits.INT0IE = 0;
+    edges = 0;
+    tickSum = 0;
+    haveEdge = 0;
+    INTCONbits.INT0IE = ie;
+    
+    return 1;
+}
+
+/* last measured oscillator error */
+int32_t CLKCAL_getErrorPpm(void) {
+    return errorPpm;
+}
+
+/* last measured instruction cycles per PPS */
+uint32_t CLKCAL_getCyclesPerPps(void) {
+    return cyclesPerPps;
+}
+
+/* oscillator within half a tuning step */
+int CLKCAL_isLocked(void) {
+    return locked;
+}
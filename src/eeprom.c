@@ -0,0 +1,75 @@
+/**
+ * @file    eeprom.c
+ * @author  Mustafa Siddiqui
+ * @brief   Function definitions for data EEPROM access on PIC18 MCU.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "../inc/eeprom.h"
+//-//
+#include <xc.h>
+
+/* point EEADRH:EEADR at a data EEPROM cell */
+static void EEPROM_setAddress(unsigned int addr) {
+    EEADRH = (unsigned char)(addr >> 8);
+    EEADR = (unsigned char)(addr & 0xFF);
+    EECON1bits.EEPGD = 0;   // data EEPROM, not flash
+    EECON1bits.CFGS = 0;    // not configuration registers
+}
+
+/* read byte from data EEPROM */
+unsigned char EEPROM_readByte(unsigned int addr) {
+    EEPROM_setAddress(addr);
+    EECON1bits.RD = 1;      // data is available in the next cycle
+    return EEDATA;
+}
+
+/* write byte to data EEPROM */
+void EEPROM_writeByte(unsigned int addr, unsigned char data) {
+    EEPROM_setAddress(addr);
+    EEDATA = data;
+    EECON1bits.WREN = 1;
+    
+    // required unlock sequence => must not be interrupted
+    unsigned char gie = INTCONbits.GIE;
+    INTCONbits.GIE = 0;
+    EECON2 = 0x55;
+    EECON2 = 0xAA;
+    EECON1bits.WR = 1;
+    INTCONbits.GIE = gie;
+    
+    // WR is cleared by hardware when the write completes
+    while (EECON1bits.WR);
+    EECON1bits.WREN = 0;
+}
+
+/* read a block of bytes */
+void EEPROM_readBlock(unsigned int addr, void *dst, unsigned int len) {
+    unsigned char *bytes = (unsigned char *)dst;
+    for (unsigned int i = 0; i < len; i++) {
+        bytes[i] = EEPROM_readByte(addr + i);
+    }
+}
+
+/* write a block of bytes, skipping cells which already match */
+void EEPROM_writeBlock(unsigned int addr, const void *src, unsigned int len) {
+    const unsigned char *bytes = (const unsigned char *)src;
+    for (unsigned int i = 0; i < len; i++) {
+        if (EEPROM_readByte(addr + i) != bytes[i]) {
+            EEPROM_writeByte(addr + i, bytes[i]);
+        }
+    }
+}
+
+/* checksum for stored records */
+unsigned char EEPROM_checksum(const void *data, unsigned int len) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    unsigned char sum = 0;
+    for (unsigned int i = 0; i < len; i++) {
+        sum += bytes[i];
+    }
+    return (unsigned char)~sum;
+}
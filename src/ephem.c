@@ -0,0 +1,107 @@
+/**
+ * @file    ephem.c
+ * @author  Mustafa Siddiqui
+ * @brief   Function definitions for the daily solar ephemeris.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "../inc/ephem.h"
+#include "../inc/eeprom.h"
+#include "../inc/fixmath.h"
+//-//
+#include <stdlib.h> // abs()
+
+#define BAM_PER_DEG 182.04444f  // 65536 / 360
+
+/* the day's table */
+static struct EPHEM_Table table;
+
+/* checksum over everything after the checksum byte */
+static unsigned char EPHEM_checksum(void) {
+    return EEPROM_checksum(&table.ordinal_date, sizeof(table) - 2);
+}
+
+/* load table from EEPROM */
+int EPHEM_init(void) {
+    EEPROM_readBlock(EE_ADDR_EPHEM, &table, sizeof(table));
+    
+    if (table.magic != EPHEM_MAGIC || table.checksum != EPHEM_checksum()) {
+        table.magic = 0;
+        return 0;
+    }
+    
+    return 1;
+}
+
+/* rebuild table for a new day or position */
+int EPHEM_update(const struct TimePos *time_pos) {
+    int16_t lat = (int16_t)(time_pos->latitude * BAM_PER_DEG);
+    int16_t lon = (int16_t)(int32_t)(time_pos->longitude * BAM_PER_DEG);
+    
+    if (table.magic == EPHEM_MAGIC && table.ordinal_date == time_pos->ordinal_date
+            && abs((int16_t)(lat - table.latitude)) <= EPHEM_MOVE_BAM
+            && abs((int16_t)(lon - table.longitude)) <= EPHEM_MOVE_BAM) {
+        return 0;
+    }
+    
+    // evaluate the sun position model at every knot of the day
+    struct TimePos knot = *time_pos;
+    int16_t angles[2];
+    for (int k = 0; k < EPHEM_KNOTS; k++) {
+        knot.time = k * EPHEM_STEP_MIN;
+        calculate_target_angles_fx(knot, angles);
+        table.zenith[k] = angles[0];
+        table.azimuth[k] = angles[1];
+    }
+    
+    table.magic = EPHEM_MAGIC;
+    table.ordinal_date = time_pos->ordinal_date;
+    table.latitude = lat;
+    table.longitude = lon;
+    table.checksum = EPHEM_checksum();
+    
+    // unchanged cells are skipped by EEPROM_writeBlock()
+    EEPROM_writeBlock(EE_ADDR_EPHEM, &table, sizeof(table));
+    
+    return 1;
+}
+
+/* linear interpolation between knot k and k + 1 */
+static int16_t EPHEM_interpolate(const int16_t *knots, int k, int frac) {
+    // difference as int16 => azimuth wraps through +-180 deg correctly
+    int16_t diff = (int16_t)(knots[k + 1] - knots[k]);
+    
+    // diff * frac / EPHEM_STEP_MIN with a multiply instead of a division
+    return knots[k] + (int16_t)(((int32_t)diff * frac * (65536L / EPHEM_STEP_MIN)) >> 16);
+}
+
+/* interpolate target angles for the given time */
+int EPHEM_getAngles(const struct TimePos *time_pos, int16_t *angles) {
+    if (table.magic != EPHEM_MAGIC) {
+        return 0;
+    }
+    
+    // age in days, across new year's too
+    int age = time_pos->ordinal_date - table.ordinal_date;
+    if (age < 0) {
+        age += 365;
+    }
+    if (age > EPHEM_MAX_AGE_DAYS) {
+        return 0;
+    }
+    
+    int k = time_pos->time / EPHEM_STEP_MIN;
+    int frac = time_pos->time - k * EPHEM_STEP_MIN;
+    if (k >= EPHEM_KNOTS - 1) {
+        k = EPHEM_KNOTS - 2;
+        frac = EPHEM_STEP_MIN;
+    }
+    
+    angles[0] = EPHEM_interpolate(table.zenith, k, frac);
+    angles[1] = EPHEM_interpolate(table.azimuth, k, frac);
+    
+    return 1;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file    filter.c
+ * @author  Mustafa Siddiqui
+ * @brief   Function definitions for streaming filters.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "../inc/filter.h"
+
+/* empty the window */
+void FILTER_avgInit(struct FILTER_Avg *f, unsigned char len) {
+    if (len < 1) {
+        len = 1;
+    } else if (len > FILTER_MAX_WINDOW) {
+        len = FILTER_MAX_WINDOW;
+    }
+    f->len = len;
+    f->sum = 0;
+    f->head = 0;
+    f->count = 0;
+}
+
+/* replace the oldest sample, keep the sum running */
+void FILTER_avgPush(struct FILTER_Avg *f, int16_t x) {
+    if (f->count == f->len) {
+        f->sum -= f->window[f->head];
+    } else {
+        f->count++;
+    }
+    f->sum += x;
+    f->window[f->head] = x;
+    if (++f->head == f->len) {
+        f->head = 0;
+    }
+}
+
+/* mean of the window */
+int16_t FILTER_avgGet(const struct FILTER_Avg *f) {
+    if (f->count == 0) {
+        return 0;
+    }
+    // round half away from zero
+    int32_t half = f->count / 2;
+    int32_t sum = (f->sum < 0) ? f->sum - half : f->sum + half;
+    return (int16_t)(sum / f->count);
+}
+
+/* spread of the window around its mean */
+uint32_t FILTER_avgVariance(const struct FILTER_Avg *f) {
+    if (f->count == 0) {
+        return 0;
+    }
+    int16_t mean = FILTER_avgGet(f);
+    uint32_t sum = 0;
+    for (unsigned char i = 0; i < f->count; i++) {
+        int32_t d = (int32_t)f->window[i] - mean;
+        uint32_t ad = (d < 0) ? (uint32_t)-d : (uint32_t)d;
+        uint32_t sq = ad * ad;     // <= 65535^2, fits
+        if (sum > UINT32_MAX - sq) {
+            return UINT32_MAX;
+        }
+        sum += sq;
+    }
+    return sum / f->count;
+}
+
+/* middle of three */
+int16_t FILTER_median3(int16_t a, int16_t b, int16_t c) {
+    if (a > b) {
+        int16_t t = a;
+        a = b;
+        b = t;
+    }
+    // a <= b => median is b clamped to [a, c] or a
+    if (c < a) {
+        return a;
+    }
+    return (c < b) ? c : b;
+}
+
+/* empty the window */
+void FILTER_medianInit(struct FILTER_Median *f) {
+    f->head = 0;
+    f->count = 0;
+}
+
+/* add a sample and take the median */
+int16_t FILTER_medianPush(struct FILTER_Median *f, int16_t x) {
+    f->window[f->head] = x;
+    if (++f->head == FILTER_MEDIAN_LEN) {
+        f->head = 0;
+    }
+    if (f->count < FILTER_MEDIAN_LEN) {
+        f->count++;
+    }
+
+#if FILTER_MEDIAN_LEN == 3
+    if (f->count == 3) {
+        return FILTER_median3(f->window[0], f->window[1], f->window[2]);
+    }
+#endif
+
+    // insertion sort of a copy => N^2 / 2 compares for small N
+    int16_t sorted[FILTER_MEDIAN_LEN];
+    for (unsigned char i = 0; i < f->count; i++) {
+        int16_t v = f->window[i];
+        unsigned char j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+    return sorted[(f->count - 1) / 2];
+}
+
+/* reset */
+void FILTER_emaInit(struct FILTER_Ema *f, unsigned char shift) {
+    f->state = 0;
+    f->shift = (shift > 15) ? 15 : shift;
+    f->primed = 0;
+}
+
+/* y += (x - y) / 2^shift in Q8 */
+void FILTER_emaPush(struct FILTER_Ema *f, int16_t x) {
+    int32_t target = (int32_t)x * 256;
+    if (!f->primed) {
+        f->state = target;
+        f->primed = 1;
+        return;
+    }
+    // step rounded away from zero => at least 1/256 LSB towards x, a
+    // plain shift would stop up to 2^shift / 256 LSB short from below
+    int32_t diff = target - f->state;
+    if (diff > 0) {
+        diff += ((int32_t)1 << f->shift) - 1;
+    }
+    f->state += diff >> f->shift;
+}
+
+/* output rounded to nearest */
+int16_t FILTER_emaGet(const struct FILTER_Ema *f) {
+    return (int16_t)((f->state + 128) >> 8);
+}
@@ -0,0 +1,155 @@
+/**
+ * @file    fixmath.c
+ * @author  Mustafa Siddiqui
+ * @brief   Function definitions for integer-only trig.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "../inc/fixmath.h"
+
+/* sin(i * 90/64 deg) in Q15, i = 0..64 => lives in program memory */
+static const int16_t sinTable[65] = {
+    0, 804, 1608, 2410, 3212, 4011, 4808, 5602, 6393, 7179, 7962, 8739,
+    9512, 10278, 11039, 11793, 12539, 13279, 14010, 14732, 15446, 16151,
+    16846, 17530, 18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790, 27245, 27683,
+    28105, 28510, 28898, 29268, 29621, 29956, 30273, 30571, 30852, 31113,
+    31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521, 32609, 32678,
+    32728, 32757, 32767
+};
+
+/* atan(i/32) as binary angle, i = 0..32 */
+static const int16_t atanTable[33] = {
+    0, 326, 651, 975, 1297, 1617, 1933, 2246, 2555, 2860, 3159, 3453,
+    3742, 4025, 4302, 4572, 4836, 5094, 5344, 5589, 5826, 6058, 6282,
+    6500, 6712, 6917, 7117, 7310, 7498, 7679, 7856, 8026, 8192
+};
+
+/* sine of a binary angle */
+int16_t FX_sin(uint16_t angle) {
+    // [quadrant(2), index(6), fraction(8)]
+    uint8_t quadrant = (uint8_t)(angle >> 14);
+    uint16_t pos = angle & 0x3FFF;
+    
+    // 2nd and 4th quadrants run the table backwards
+    if (quadrant & 1) {
+        pos = 0x4000 - pos;
+    }
+    
+    uint8_t index = (uint8_t)(pos >> 8);
+    uint8_t frac = (uint8_t)(pos & 0xFF);
+    int16_t value = sinTable[index];
+    if (frac) {
+        value += (int16_t)(((int32_t)(sinTable[index + 1] - value) * frac) >> 8);
+    }
+    
+    // 3rd and 4th quadrants are negative
+    return (quadrant & 2) ? -value : value;
+}
+
+/* cosine of a binary angle */
+int16_t FX_cos(uint16_t angle) {
+    return FX_sin(angle + FX_BAM_90);
+}
+
+/* quadrant-aware arctan(y/x) as binary angle */
+int16_t FX_atan2(int32_t y, int32_t x) {
+    uint32_t ax = (x < 0) ? -(uint32_t)x : (uint32_t)x;
+    uint32_t ay = (y < 0) ? -(uint32_t)y : (uint32_t)y;
+    uint32_t num, den;
+    
+    if (ax == 0 && ay == 0) {
+        return 0;
+    }
+    
+    // reduce to the first octant: ratio = small / large in [0, 1]
+    if (ay <= ax) {
+        num = ay;
+        den = ax;
+    } else {
+        num = ax;
+        den = ay;
+    }
+    
+    // keep the division 32/16 bits
+    while (den > 0xFFFF) {
+        num >>= 1;
+        den >>= 1;
+    }
+    
+    // ratio in Q13 => [index(5), fraction(8)]
+    uint16_t ratio = (uint16_t)((num << 13) / den);
+    uint8_t index = (uint8_t)(ratio >> 8);
+    uint8_t frac = (uint8_t)(ratio & 0xFF);
+    int16_t angle = atanTable[index];
+    if (frac) {
+        angle += (int16_t)(((int32_t)(atanTable[index + 1] - angle) * frac) >> 8);
+    }
+    
+    // unfold the octant
+    if (ay > ax) {
+        angle = FX_BAM_90 - angle;
+    }
+    if (x < 0) {
+        angle = (int16_t)(FX_BAM_180 - (uint16_t)angle);
+    }
+    if (y < 0) {
+        angle = -angle;
+    }
+    
+    return angle;
+}
+
+/* integer square root */
+uint16_t FX_isqrt(uint32_t num) {
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+    
+    while (bit > num) {
+        bit >>= 2;
+    }
+    
+    while (bit != 0) {
+        if (num >= root + bit) {
+            num -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    
+    return (uint16_t)root;
+}
+
+/* length of a 3-axis vector */
+uint16_t FX_magnitude(int16_t x, int16_t y, int16_t z) {
+    // each square <= 2^30 => the sum of three fits 32 bits unsigned
+    uint32_t sum = (uint32_t)((int32_t)x * x);
+    sum += (uint32_t)((int32_t)y * y);
+    sum += (uint32_t)((int32_t)z * z);
+    
+    // round to nearest: (r + 0.5)^2 = r^2 + r + 0.25
+    uint16_t root = FX_isqrt(sum);
+    if (sum - (uint32_t)root * root > root) {
+        root++;
+    }
+    return root;
+}
+
+/* arccosine of a Q15 value as binary angle */
+uint16_t FX_acos(int16_t c) {
+    if (c < -FX_ONE) {
+        c = -FX_ONE;
+    }
+    
+    // sin = sqrt(1 - cos^2) in Q15 => 1.0^2 = FX_ONE^2, so c = 1 gives 0
+    int32_t c2 = (int32_t)c * c;
+    uint16_t s = FX_isqrt((uint32_t)FX_ONE * FX_ONE - (uint32_t)c2);
+    
+    // sin >= 0 => result in [0, 180] deg
+    return (uint16_t)FX_atan2(s, c);
+}
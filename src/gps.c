@@ -11,57 +11,15 @@
 #include "../inc/gps.h"
 #include <math.h>
 #include "../inc/uart.h"
+#include "../inc/fixmath.h"
 
+#define BAM_PER_DEG     182.04444f  //65536 / 360
 
-/*
- * given NMEA GPRMC string
- * return a timePos object that represents time, latitude and longitude
- */
-struct TimePos parse_GPRMC(const char* input_str) {
-
-    struct TimePos timePosobj;
-  
-    char str[100];
-    memcpy(str, input_str, 100);
-
-    const char delimiter[2] = ",";
-    
-    char * token;
-    int i = 1;
-    
-   /* get the first token */
-   token = strtok(str, delimiter);
-   
-   /* walk through other tokens */
-   while( token != NULL ) {
-       i = i+1;
-       token = strtok(NULL, delimiter);
-       
-       if (i == 2) {
-           timePosobj.time = str_to_minute(token);
-       } else if(i==4) {
-           timePosobj.latitude = str_to_latitude(token);
-       } else if(i==5) {
-           if ( (token[0] == 'S') || (token[0] == 's')){
-               timePosobj.latitude = -timePosobj.latitude;
-           }
-       } else if(i==6) {
-           timePosobj.longitude = str_to_longitude(token);
-       } else if(i==7) {
-           if ( (token[0] == 'W') || (token[0] == 'w')){
-               timePosobj.longitude = -timePosobj.longitude;
-           }
-       } else if(i==10) {
-           timePosobj.ordinal_date = str_to_ordinal_date(token);
-       }
-   }
-     
-    return timePosobj;
-}
 
 /*
  * calculates the target zenith and azimuth angles based on latitude, longitude, and time
  */
+#ifndef SUN_FIXED_POINT
 void calculate_target_angles(struct TimePos time_pos, float* angles){
 
     int N = time_pos.ordinal_date - 1;
@@ -85,245 +43,110 @@ void calculate_target_angles(struct TimePos time_pos, float* angles){
     angles[1] = (float) (atan2(Sx, Sy)*DEGREES_CONST); //Azimuth
 
 }
+#else
+void calculate_target_angles(struct TimePos time_pos, float* angles){
+    int16_t fx_angles[2];
 
-/*
- * return 1 if the input string starts with "$GPRMC"
- */
-int is_GPRMC(char* str){
-    char newStr[7];
-    newStr[6] = '\0';
-    memcpy(newStr, str, 6);
-    return !strcmp(newStr, "$GPRMC");
+    calculate_target_angles_fx(time_pos, fx_angles);
+
+    angles[0] = FX_BAM_TO_CDEG(fx_angles[0]) / 100.0f; //Zenith
+    angles[1] = FX_BAM_TO_CDEG(fx_angles[1]) / 100.0f; //Azimuth
 }
+#endif /* SUN_FIXED_POINT */
 
 /*
- * return the ordinal date of a string in DDMMYY format 
+ * same model as calculate_target_angles() in integer arithmetic only
+ * angles are returned as binary angles (65536 = 360 deg), see fixmath.h
  */
-int str_to_ordinal_date(char* str) {
-    //break up string into DD MM and YY
-    int DD = 10*(str[0] - '0') + (str[1] - '0');
-    int MM = 10*(str[2] - '0') + (str[3] - '0');
-    int YY = 10*(str[4] - '0') + (str[5] - '0');
-    
-    int days_in_feb = 28;
-    int doy = DD;
+void calculate_target_angles_fx(struct TimePos time_pos, int16_t* angles){
 
-    // check for leap year
-    if( (YY % 4 == 0 && YY % 100 != 0 ) || (YY % 400 == 0) )
-    {
-        days_in_feb = 29;
-    }
+    int32_t N = time_pos.ordinal_date - 1;
 
-    switch(MM)
-    {
-        case 2:
-            doy += 31;
-            break;
-        case 3:
-            doy += 31+days_in_feb;
-            break;
-        case 4:
-            doy += 62+days_in_feb;
-            break;
-        case 5:
-            doy += 92+days_in_feb;
-            break;
-        case 6:
-            doy += 123+days_in_feb;
-            break;
-        case 7:
-            doy += 153+days_in_feb;
-            break;            
-        case 8:
-            doy += 184+days_in_feb;
-            break;
-        case 9:
-            doy += 215+days_in_feb;
-            break;
-        case 10:
-            doy += 245+days_in_feb;            
-            break;            
-        case 11:
-            doy += 276+days_in_feb;            
-            break;                        
-        case 12:
-            doy += 306+days_in_feb;            
-            break;                                    
-    }
+    //0.017203 rad/day = 179.434 BAM/day (x256 = 45935)
+    uint16_t day_angle = (uint16_t)(((N + 10) * 45935L) >> 8);
+    uint16_t ecc_angle = (uint16_t)(((N - 2) * 45935L) >> 8);
+    //+ 0.033406 rad = 348.43 BAM (x64 = 22300)
+    day_angle += (int16_t)(((int32_t)FX_sin(ecc_angle) * 22300L) >> 21);
+
+    //declination: sin(Ps) = -0.39779*cos(day_angle), 0.39779 = 13035 in Q15
+    int32_t sinPs = -((13035L * FX_cos(day_angle)) >> 15);
+    int32_t cosPs = FX_isqrt((1UL << 30) - (uint32_t)(sinPs * sinPs));
 
-    return doy;
+    //hour angle = ls - longitude where ls = 180 - minute/4 deg
+    //1/4 deg = 45.511 BAM (x256 = 11651)
+    uint16_t lon = (uint16_t)(int32_t)(time_pos.longitude * BAM_PER_DEG);
+    uint16_t hour_angle = (uint16_t)(FX_BAM_180 - (((int32_t)time_pos.time * 11651L) >> 8)) - lon;
+
+    uint16_t Po = (uint16_t)(int32_t)(time_pos.latitude * BAM_PER_DEG);
+    int32_t sinPo = FX_sin(Po);
+    int32_t cosPo = FX_cos(Po);
+    int32_t cosH = FX_cos(hour_angle);
+
+    //sun vector in Q15
+    int32_t Sx = (cosPs * FX_sin(hour_angle)) >> 15;
+    int32_t Sy = ((cosPo * sinPs) >> 15) - ((((sinPo * cosPs) >> 15) * cosH) >> 15);
+    int32_t Sz = ((sinPo * sinPs) >> 15) + ((((cosPo * cosPs) >> 15) * cosH) >> 15);
+
+    //acos(Sz) as atan2(|Sxy|, Sz) keeps full resolution near the zenith
+    int32_t Sxy = FX_isqrt((uint32_t)(Sx * Sx + Sy * Sy));
+    int16_t zenith = FX_atan2(Sxy, Sz);
+
+    angles[0] = (zenith < 0) ? INT16_MAX : zenith;  //180 deg (nadir) wraps negative
+    angles[1] = FX_atan2(Sx, Sy);
 }
 
 /*
- * return minute of the day given string in hhmmss.ss format
+ * waits for the next valid fix and returns its time and position
  */
-int str_to_minute(char* str) {
-    return 600* (str[0] - '0') + 60* (str[1] - '0') + 10* (str[2] - '0') + (str[3] - '0');
+void get_time_pos(struct TimePos* tp){
+    struct NMEA_Parser parser;
+
+    //decode the sentence as it arrives, no copies of it are kept
+    init_NMEA_Parser(&parser);
+    while (!parse_NMEA_char(&parser, UART_Read_char(), tp));
 }
 
 /*
- * return latitude given string in DDmm.mm format
+ * parser used by poll_time_pos(), zeroed => waiting for '$'
  */
-float str_to_latitude(char* str) {
-    return (float)(atof(str) / 100);
-}
+static struct NMEA_Parser stream_parser;
 
 /*
- * return longitude given string in DDDmm.mm format
+ * counters of the parser used by poll_time_pos()
  */
-float str_to_longitude(char* str) {
-    return (float)(atof(str) / 100);
+void get_NMEA_Stats(struct NMEA_Stats* stats){
+    *stats = stream_parser.stats;
 }
 
 /*
- * return 1 if the input string is able to be parsed
+ * latest fix of the parser used by poll_time_pos(), check fix->valid
  */
-int is_Valid_GPRMC(char* str){
-
-
-    //TODO check that none of the data is invalid
-
-
-    //make copy of input string to avoid problems
-    char newStr[100];
-    memcpy(newStr, str, 100);
-
-    //calculate the correct checksum
-    int correct_checksum = calc_NMEA_Checksum(str, (int)strlen(str));
-   
-    //break up string
-    const char delimiter[2] = ",";
-    char * token;
-    int i = 1;
-    char * check_str = malloc(sizeof(char)*5);
-
-    
-    /* get the first token */
-    token = strtok(newStr, delimiter);
-    /* walk through other tokens */
-    while( token != NULL ) {
-       i = i+1;
-       token = strtok(NULL, delimiter);
-
-       if (i ==13) { 
-            check_str = token;
-       } 
-    }
-    
-    if (i != 14) {
-        free(check_str);
-        return 0;
-    }
-    //validate the check string
-    if (check_str[1] != '*') {
-        free(check_str);
-       return 0;
-    }
-    if(check_str[0] == 'N') {
-        free(check_str);
-        return 0;
-    } 
-
-    //validate the checksum
-    char check_valid[3];
-    sprintf(check_valid, "%x", correct_checksum);
-    char* checksum_str = &check_str[2];
-
-
-    if ((check_valid[0]!=checksum_str[0] || check_valid[1]!=checksum_str[1])){
-        free(check_str);
-        return 0;
-    }
-
-    
-
-    return 1;
-    
+void get_NMEA_Fix(struct NMEA_Fix* fix){
+    *fix = stream_parser.fix;
 }
 
-
 /*
- * calculates the NMEA Checksum for a given string
+ * decodes whatever the UART has received so far without waiting
+ * return 1 and fill *tp when a usable fix was completed
  */
-int calc_NMEA_Checksum( char *buf, int cnt )
-{
-    char Character;
-    int Checksum = 0;
-    int i;              // loop counter
-
-
+int poll_time_pos(struct TimePos* tp){
+    char data;
 
-    //for each(char Character in sentence)
-    for (i=0;i<cnt;++i)
-    {
-        Character = buf[i];
-        switch(Character)
-        {
-            case '$':
-                // Ignore the dollar sign
-                break;
-            case '*':
-                // Stop processing before the asterisk
-                i = cnt;
-                continue;
-            default:
-                // Is this the first value for the checksum?
-                if (Checksum == 0)
-                {
-                    // Yes. Set the checksum to the value
-                    Checksum = Character;
-                }
-                else
-                {
-                    // No. XOR the checksum with this character's value
-                    Checksum = Checksum ^ Character;
-                }
-                break;
+    while (UART_try_read_char(&data)) {
+        if (parse_NMEA_char(&stream_parser, data, tp)) {
+            return 1;
         }
     }
 
-    // Return the checksum
-    return (Checksum);
-
+    return 0;
 }
 
-
 /*
  * returns a list of two floats representing zenith and azimuth angles
  */
 void get_target_angles(float* angles){
     struct TimePos tp;
-    char data;
-    memset(UART_buffer,0,sizeof(UART_buffer));
-    int done = 0;
-    
-    while (!done){
-        while(data != '$') {            //wait to receive $
-            data = UART_Read_char();
-        }
-        strncat(UART_buffer, &data, 1);
-        while(data != '\r') {           //save the entire string
-            data = UART_Read_char();
-            strncat(UART_buffer, &data, 1);
-        }
-        
-        if(is_GPRMC(UART_buffer)) {     //validate the string
-            if (is_Valid_GPRMC(UART_buffer)) {
-                done = 1; 
-            } else {
-                memset(UART_buffer,0,sizeof(UART_buffer));
-            }
-        } else {
-            memset(UART_buffer,0,sizeof(UART_buffer));
-        }
-    }
-    
-    char newStr[100];
-    memcpy(newStr, UART_buffer, 100);
-    
-    tp = parse_GPRMC(newStr);
-    
-    
+
+    get_time_pos(&tp);
     calculate_target_angles(tp, angles);
-    
 }
@@ -0,0 +1,110 @@
+/**
+ * @file    gpsaid.c
+ * @author  Carter Bordeleau, Mustafa Siddiqui
+ * @brief   Function definitions for the aided EM506 start.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "../inc/gpsaid.h"
+#include "../inc/eeprom.h"
+#include "../inc/uart.h"    // UART_send_str()
+#include "../inc/rtc.h"     // RTC_getUptime()
+//-//
+#include <stdio.h>  // sprintf()
+
+/* days from the GPS epoch (06/01/1980) to 01/01/2000 */
+#define GPS_DAYS_TO_2000    7300UL
+
+static struct GPSAID_Record record;
+static unsigned char aided;
+static unsigned char have_fix;
+static unsigned int ttff;
+static unsigned long start_uptime;
+static unsigned long save_uptime;
+
+/* checksum over the stored fix */
+static unsigned char GPSAID_checksum(void) {
+    return EEPROM_checksum(&record.fix, sizeof(record.fix));
+}
+
+/* signed decimal degrees with 5 places, no float printf needed */
+static int GPSAID_formatDegrees(char *str, float degrees) {
+    const char *sign = "";
+    if (degrees < 0) {
+        sign = "-";
+        degrees = -degrees;
+    }
+    unsigned long scaled = (unsigned long)(degrees * 100000.0f + 0.5f);
+    return sprintf(str, "%s%lu.%05lu", sign, scaled / 100000UL, scaled % 100000UL);
+}
+
+/* send $PSRF104 */
+void GPSAID_sendInit(const struct TimePos *time_pos) {
+    char cmd[80];
+    int len;
+
+    // GPS week and time of week from the UTC date
+    unsigned long days = GPS_DAYS_TO_2000 + 365UL * time_pos->year
+                       + (time_pos->year + 3) / 4 + time_pos->ordinal_date - 1;
+    unsigned int week = (unsigned int)(days / 7);
+    unsigned long tow = (days % 7) * 86400UL + time_pos->time * 60UL
+                      + time_pos->second + GPSAID_LEAP_S;
+
+    //$PSRF104,<lat>,<lon>,<alt m>,<clock offset 0 = default>,<TOW>,<week>,<channels>,<reset cfg>*CS
+    len = sprintf(cmd, "$PSRF104,");
+    len += GPSAID_formatDegrees(cmd + len, time_pos->latitude);
+    cmd[len++] = ',';
+    len += GPSAID_formatDegrees(cmd + len, time_pos->longitude);
+    len += sprintf(cmd + len, ",0,0,%lu,%u,%u,%u*", tow, week, GPSAID_CHANNELS, GPSAID_RESET_CFG);
+    sprintf(cmd + len, "%02X\r\n", calc_NMEA_Checksum(cmd, len));
+    UART_send_str(cmd);
+}
+
+/* load the last fix and aid the receiver with it */
+int initGPSAid(void) {
+    start_uptime = RTC_getUptime();
+    have_fix = 0;
+    ttff = 0;
+    aided = 0;
+
+    EEPROM_readBlock(EE_ADDR_GPSAID, &record, sizeof(record));
+    if (record.magic == GPSAID_MAGIC && record.checksum == GPSAID_checksum()) {
+        GPSAID_sendInit(&record.fix);
+        aided = 1;
+    }
+
+    return aided;
+}
+
+/* time to first fix and rate limited save */
+int GPSAID_fix(const struct TimePos *time_pos) {
+    unsigned long now = RTC_getUptime();
+    int first = !have_fix;
+
+    if (!first && now - save_uptime < GPSAID_SAVE_S) {
+        return 0;
+    }
+
+    if (first) {
+        ttff = (unsigned int)(now - start_uptime);
+        have_fix = 1;
+    }
+
+    record.magic = GPSAID_MAGIC;
+    record.fix = *time_pos;
+    record.checksum = GPSAID_checksum();
+
+    // only the changed cells are written, mostly the time
+    EEPROM_writeBlock(EE_ADDR_GPSAID, &record, sizeof(record));
+    save_uptime = now;
+    return first;
+}
+
+/* time to first fix of this boot */
+unsigned int GPSAID_getTTFF(unsigned char *was_aided) {
+    *was_aided = aided;
+    return ttff;
+}
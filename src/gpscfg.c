@@ -0,0 +1,229 @@
+/**
+ * @file    gpscfg.c
+ * @author  Carter Bordeleau, Mustafa Siddiqui
+ * @brief   Function definitions for EM506 sentence configuration.
+ * @date    10/16/2026
+ * 
+ * 
+ */
+
+#include "../inc/gpscfg.h"
+#include "../inc/gps.h"     // calc_NMEA_Checksum(), get_NMEA_Stats()
+#include "../inc/uart.h"    // UART_send_str(), UART_set_baud()
+#include "../inc/rtc.h"     // RTC_getUptime()
+
+/*
+ * rate for each sentence type, 0 = off
+ */
+static const struct {
+    unsigned char msg;
+    unsigned char rate;
+} sentence_rates[] = {
+    {SIRF_GGA, GPSCFG_GGA_RATE},
+    {SIRF_GLL, 0},
+    {SIRF_GSA, 0},
+    {SIRF_GSV, 0},
+    {SIRF_RMC, GPSCFG_RMC_RATE},
+    {SIRF_VTG, 0},
+    {SIRF_ZDA, 0},
+};
+
+#define NUM_SENTENCES (sizeof(sentence_rates) / sizeof(sentence_rates[0]))
+
+static const unsigned long baud_rates[] = GPSCFG_BAUD_RATES;
+
+#define NUM_BAUD_RATES (sizeof(baud_rates) / sizeof(baud_rates[0]))
+
+static struct GPSCFG_Report report;
+static unsigned long window_start;      //uptime when the window opened
+static struct NMEA_Stats window_stats;  //parser counters when it opened
+static unsigned int window_lost;        //UART RX bytes lost when it opened
+static unsigned char next_baud;         //index into baud_rates[] to try next
+
+/*
+ * RX bytes the UART driver has lost so far, dropped or overrun
+ */
+static unsigned int rx_lost(void){
+    struct UART_Stats uart;
+    UART_get_stats(&uart);
+    return uart.rx_dropped + uart.rx_overruns;
+}
+
+/*
+ * open a new measurement window
+ */
+static void start_window(void){
+    window_start = RTC_getUptime();
+    get_NMEA_Stats(&window_stats);
+    window_lost = rx_lost();
+}
+
+/*
+ * return 1 if the window is over and fill in what it saw, 0 if not
+ * => a window that lost RX bytes (main code busy, ring overflowed)
+ *    undercounts every sentence type, so it is thrown away: returns
+ *    -1 and a new window is started
+ */
+static int end_window(unsigned long seconds, unsigned int* bytes_per_fix, unsigned int* rmc, unsigned int* other){
+    struct NMEA_Stats now;
+
+    if (RTC_getUptime() - window_start < seconds) {
+        return 0;
+    }
+    if (rx_lost() != window_lost) {
+        report.lost_windows++;
+        start_window();
+        return -1;
+    }
+
+    get_NMEA_Stats(&now);
+    unsigned long bytes = now.bytes - window_stats.bytes;
+    unsigned int fixes = now.fixes - window_stats.fixes;
+    *rmc = now.rmc - window_stats.rmc;
+    *other = now.other - window_stats.other;
+    *bytes_per_fix = fixes ? (unsigned int)(bytes / fixes) : 0xFFFF;
+    
+    return 1;
+}
+
+/*
+ * append checksum and line ending to "$...*" and send it
+ */
+static void send_command(char* cmd, int len){
+    sprintf(cmd + len, "%02X\r\n", calc_NMEA_Checksum(cmd, len));
+    UART_send_str(cmd);
+}
+
+/*
+ * send a $PSRF103 rate command for every sentence type
+ */
+void GPSCFG_sendCommands(void){
+    char cmd[32];
+    int len;
+
+    for (unsigned char i = 0; i < NUM_SENTENCES; i++) {
+        //$PSRF103,<msg>,<mode 00 = set rate>,<rate>,<checksum on>*CS
+        len = sprintf(cmd, "$PSRF103,%02u,00,%02u,01*", sentence_rates[i].msg, sentence_rates[i].rate);
+        send_command(cmd, len);
+    }
+
+    report.attempts++;
+}
+
+/*
+ * tell the receiver the new rate, then follow it
+ */
+void GPSCFG_setBaud(unsigned long baud){
+    char cmd[40];
+    int len;
+
+    //$PSRF100,<1 = NMEA>,<baud>,<data bits>,<stop bits>,<parity 0 = none>*CS
+    len = sprintf(cmd, "$PSRF100,1,%lu,8,1,0*", baud);
+    send_command(cmd, len);
+
+    //UART_set_baud() waits for the command to leave at the old rate
+    UART_set_baud(baud);
+    report.baud = baud;
+    report.baud_attempts++;
+}
+
+/*
+ * measure the default mix first
+ */
+void initGPSConfig(void){
+    memset(&report, 0, sizeof(report));
+    report.baud = UART_get_baud();
+    report.state = GPSCFG_MEASURE_DEFAULT;
+    next_baud = 0;
+    start_window();
+}
+
+/*
+ * advance the configure/verify sequence
+ */
+int GPSCFG_service(void){
+    unsigned int bytes_per_fix;
+    unsigned int rmc;
+    unsigned int other;
+    int done;
+
+    switch (report.state) {
+        case GPSCFG_MEASURE_DEFAULT:
+            if (end_window(GPSCFG_WINDOW_S, &bytes_per_fix, &rmc, &other) > 0) {
+                report.bytes_per_fix_before = bytes_per_fix;
+                GPSCFG_sendCommands();
+                report.state = GPSCFG_SETTLE;
+                start_window();
+            }
+            break;
+        case GPSCFG_SETTLE:
+            //nothing is measured => a window that lost bytes will do
+            if (end_window(GPSCFG_SETTLE_S, &bytes_per_fix, &rmc, &other) != 0) {
+                report.state = GPSCFG_VERIFY;
+                start_window();
+            }
+            break;
+        case GPSCFG_VERIFY:
+        case GPSCFG_CONFIGURED:
+            if (end_window(GPSCFG_WINDOW_S, &bytes_per_fix, &rmc, &other) <= 0) {
+                break;
+            }
+            if (rmc == 0 && other == 0 && UART_get_baud() != UART_DEFAULT_BAUD) {
+                //silent at a raised rate => receiver reset to its default
+                UART_set_baud(UART_DEFAULT_BAUD);
+                report.baud = UART_DEFAULT_BAUD;
+                next_baud = 0;
+                report.state = GPSCFG_VERIFY;
+                start_window();
+            } else if (other == 0 && rmc > 0) {
+                //only wanted sentences => the commands took effect
+                if (bytes_per_fix != 0xFFFF) {
+                    report.bytes_per_fix_after = bytes_per_fix;
+                }
+                report.state = GPSCFG_CONFIGURED;
+                if (next_baud < NUM_BAUD_RATES && UART_get_baud() == UART_DEFAULT_BAUD) {
+                    GPSCFG_setBaud(baud_rates[next_baud]);
+                    report.state = GPSCFG_BAUD_CONFIRM;
+                }
+                start_window();
+            } else {
+                //receiver was reset or a command was lost
+                GPSCFG_sendCommands();
+                report.state = GPSCFG_SETTLE;
+                start_window();
+            }
+            break;
+        case GPSCFG_BAUD_CONFIRM:
+            done = end_window(GPSCFG_BAUD_WINDOW_S, &bytes_per_fix, &rmc, &other);
+            if (done == 0) {
+                break;
+            }
+            //lost bytes => main code doesn't poll often enough for this
+            //rate, so it fails like a garbled link would
+            if (done > 0 && rmc > 0) {
+                //sentences pass checksum at the new rate => keep it
+                next_baud = NUM_BAUD_RATES;
+                report.state = GPSCFG_CONFIGURED;
+            } else {
+                //garbled or silent => undo in case the receiver did switch,
+                //then try the next rate once the default rate checks out
+                GPSCFG_setBaud(UART_DEFAULT_BAUD);
+                next_baud++;
+                report.state = GPSCFG_VERIFY;
+            }
+            start_window();
+            break;
+        default:
+            initGPSConfig();
+            break;
+    }
+
+    return report.state;
+}
+
+/*
+ * copy the measurements
+ */
+void GPSCFG_getReport(struct GPSCFG_Report* out){
+    *out = report;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file    isr.c
+ * @author  Mustafa Siddiqui
+ * @brief   Interrupt service routine for the PIC18 MCU.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "../inc/isr.h"
+#include "../inc/uart.h"    // UART_ISR()
+#include "../inc/rtc.h"     // RTC_ISR()
+#include "../inc/clkcal.h"  // CLKCAL_ISR()
+#include "../inc/accel.h"   // ACCEL_ISR()
+#include "../inc/mag.h"     // MAG_ISR()
+#include "../inc/orient.h"  // ORIENT_ISR()
+#include "../inc/spi.h"     // SPI_ISR()
+//-//
+#include <xc.h>
+
+/* enable interrupts with high/low priority vectors */
+void initInterrupts(void) {
+    // peripheral priority bits (IPRx) reset to high and INT0 is always
+    // high, so only sources that clear their IP bit run at low priority
+    RCONbits.IPEN = 1;      // two interrupt vectors
+    INTCONbits.GIEL = 1;    // low priority enable
+    INTCONbits.GIEH = 1;    // high priority (global) enable
+}
+
+/* high priority => short handlers that must not wait: UART, clock, PPS */
+void __interrupt(high_priority) ISR(void) {
+    UART_ISR();
+    RTC_ISR();
+    CLKCAL_ISR();
+}
+
+/* low priority => sensor data-ready handlers, these use SPI */
+void __interrupt(low_priority) ISR_low(void) {
+    ACCEL_ISR();
+    MAG_ISR();
+    SPI_ISR();      // queued transfers, e.g. the magnetometer read
+    ORIENT_ISR();   // after the others => sees the samples they just took
+}
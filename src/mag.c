@@ -8,8 +8,14 @@
  * 
  */
 
-#include "../inc/spi.h"
+#include "../inc/spi.h"     // SPI_tune(), SPI_submit()
+#include "../inc/regbus.h"  // REGBUS_*()
 #include "../inc/mag.h"
+#include "../inc/rtc.h"     // RTC_getTicks()
+#include "../inc/sensorcfg.h" // SENSORCFG_applyMag()
+#include "../inc/fixmath.h" // FX_atan2()
+#include "../inc/filter.h"  // FILTER_*()
+#include "../inc/magcal.h"  // MAGCAL_correct()
 #ifdef DEBUG
 #include "../inc/uart.h"
 #endif /* DEBUG */
@@ -18,70 +24,41 @@
 #include <stdio.h>  // sprintf()
 #include <stdlib.h>
 #include <string.h> // memset()
-#include <math.h>
-
-// Function that creates byte of data to be transmitted from PIC to Magnetometer
-// First input is Read/Write Bit
-// Second input is register address for magnetometer
-// SPI Write Protocol:
-// Bit 0 --> Read/Write Bit  --> 0 is write
-// Bits 1-7 --> Address of register in magnetometer
-// Bits 8-15 --> Data to be transmitted, MSb first
-unsigned char Create_MagData(int RW, unsigned char address){
-    unsigned char Data_Transmit = 0x00;
-    Data_Transmit |= address;
-
-    // set read/write bit
-    if (RW == 1)
-        SET(Data_Transmit, 7);
-    else
-        CLEAR(Data_Transmit, 7);
-
-    return Data_Transmit;
-}
+
+// filled by MAG_ISR() on every DRDY edge
+static volatile struct SensorSample slot;
+
+// streaming filters fed by MAG_ISR() => median of 3, moving average
+static struct FILTER_Median median[NUM_AXIS];
+static struct FILTER_Avg average[NUM_AXIS];
+static volatile struct SensorSample filtered;
+
+static void MAG_ReadDone(struct SPI_Transaction* t);
+static void MAG_Store(const int16_t* sensorData, uint32_t ticks);
+
+// DRDY read queued by MAG_ISR() => OUTX_L..OUTZ_H in one burst
+static uint8_t readCmd;
+static uint8_t readRaw[6];
+static struct SPI_Transaction readOut;
+static uint32_t readTicks;
+
+// [R/W, address] => the LIS2MDL increments the register address after
+// each byte by itself, see regbus.h
+static const struct REGBUS_Device bus = {MAGNETOMETER, 0x80, 0x00, 0x7F};
 
 /* write to register on Magnetometer */
 signed char MAG_Write(unsigned char address, unsigned char data_transmit) {
-    // First byte is R/W bit, and address we write to
-    // Second byte is data to be written
-    unsigned char RW_Address = Create_MagData(0, address);
-    
-    // start transmission by pulling ~CS low
-    _SPI_selectSlave(MAGNETOMETER);
-    
-    signed char status1 = _SPI_write(RW_Address);
-    signed char status2 = _SPI_write(data_transmit);
-
-    // end transmission by setting ~CS high
-    _SPI_unselectSlave(MAGNETOMETER);
-    
-    // write not successful; collision occurred somewhere
-    if ((status1 != 0) || (status2 != 0)) {
-        return -1;
-    }
-    return 0;
+    return REGBUS_write(&bus, address, data_transmit);
 }
 
 /* read from register on magnetometer */
-// Read/Write bit of 1 is to read
 unsigned char MAG_Read(unsigned char address) {
-    // to store received data
-    unsigned char recieved_data = 0x00;
+    return REGBUS_read(&bus, address);
+}
 
-    // first byte consists of R/W and address of register to read
-    unsigned char RW_Address = Create_MagData(1, address);
-    
-    // start transmission by pulling ~CS low
-    _SPI_selectSlave(MAGNETOMETER);
-    
-    // write on MOSI line & receive on MISO line
-    _SPI_write(RW_Address);
-    recieved_data = _SPI_read();
-    
-    // end transmission by setting ~CS high
-    _SPI_unselectSlave(MAGNETOMETER); 
-    
-    return recieved_data;
+/* read consecutive registers on magnetometer */
+void MAG_ReadBurst(unsigned char address, uint8_t* data, unsigned char len) {
+    REGBUS_readBlock(&bus, address, data, len);
 }
 
 /* get device ID */
@@ -92,12 +69,20 @@ unsigned char Get_MAG_ID(void) {
 /* get x,y,z sensor reading from magnetometer */
 void MAG_Data(int16_t* sensorData) {
     // OUT Registers provide us with Magnetometer raw data
-    uint8_t X1 = MAG_Read(OUTX_L_REG);    //L--> Low Bits
-    uint8_t X2 = MAG_Read(OUTX_H_REG);    //H--> High Bits
-    uint8_t Y1 = MAG_Read(OUTY_L_REG);
-    uint8_t Y2 = MAG_Read(OUTY_H_REG);
-    uint8_t Z1 = MAG_Read(OUTZ_L_REG);
-    uint8_t Z2 = MAG_Read(OUTZ_H_REG);
+    // => one burst, reading them also clears DRDY
+    uint8_t raw[6];
+    MAG_ReadBurst(OUTX_L_REG, raw, sizeof(raw));
+    MAG_Combine(raw, sensorData);
+}
+
+// combine the OUTX_L..OUTZ_H bytes into x, y, z
+void MAG_Combine(const uint8_t* raw, int16_t* sensorData) {
+    uint8_t X1 = raw[0];    //L--> Low Bits
+    uint8_t X2 = raw[1];    //H--> High Bits
+    uint8_t Y1 = raw[2];
+    uint8_t Y2 = raw[3];
+    uint8_t Z1 = raw[4];
+    uint8_t Z2 = raw[5];
     
     // combine high and low values into one number
     // bits represent signed 2's complement format
@@ -106,28 +91,108 @@ void MAG_Data(int16_t* sensorData) {
     int16_t z = (Z2 << 8) | Z1;
 
     // populate var
-    memset(sensorData, 0, NUM_AXIS * sizeof(sensorData[0]));
-    sensorData[0] = x + xAxisMagOffset;
-    sensorData[1] = y + yAxisMagOffset;
+    // => hard-iron offsets are subtracted by the sensor, see SENSORCFG_applyMag()
+    sensorData[0] = x;
+    sensorData[1] = y;
     sensorData[2] = z;
 }
 
-// get average of NUM_READINGS
+/* copy latest sample, 1 if it is newer than the one in *sample */
+int MAG_getSample(struct SensorSample* sample) {
+    // the slot is written at low priority
+    unsigned char giel = INTCONbits.GIEL;
+    INTCONbits.GIEL = 0;
+    int fresh = (slot.seq != 0 && slot.seq != sample->seq);
+    if (fresh) {
+        memcpy(sample, (const void *)&slot, sizeof(*sample));
+    }
+    INTCONbits.GIEL = giel;
+    return fresh;
+}
+
+/* copy the filtered state, 1 if there is one */
+int MAG_getFiltered(struct SensorSample* sample) {
+    // written at low priority
+    unsigned char giel = INTCONbits.GIEL;
+    INTCONbits.GIEL = 0;
+    memcpy(sample, (const void *)&filtered, sizeof(*sample));
+    INTCONbits.GIEL = giel;
+    return sample->seq != 0;
+}
+
+/* new sample on DRDY => queue its read */
+void MAG_ISR(void) {
+    if (!(INTCON3bits.INT2IE && INTCON3bits.INT2IF)) {
+        return;
+    }
+    INTCON3bits.INT2IF = 0;
+
+    // a read still queued takes this sample too, and clears DRDY
+    if (!readOut.done) {
+        return;
+    }
+    
+    // queued => the bytes shift in while the main loop runs on
+    readTicks = RTC_getTicks();
+    if (SPI_submit(&readOut) != 0) {
+        // queue full => DRDY must still be cleared, read it here
+        int16_t sensorData[NUM_AXIS];
+        MAG_Data(sensorData);
+        MAG_Store(sensorData, readTicks);
+    }
+}
+
+// queued DRDY read done => low priority, or a blocking select
+static void MAG_ReadDone(struct SPI_Transaction* t) {
+    int16_t sensorData[NUM_AXIS];
+    MAG_Combine(t->rx, sensorData);
+    MAG_Store(sensorData, readTicks);
+}
+
+// new sample => slot and filters
+static void MAG_Store(const int16_t* sensorData, uint32_t ticks) {
+    for (int c = 0; c < NUM_AXIS; c++) {
+        slot.axis[c] = sensorData[c];
+    }
+    slot.ticks = ticks;
+    slot.count = 1;
+    slot.seq = SAMPLE_NEXT_SEQ(slot.seq);
+    
+    // O(NUM_AXIS) => a spike in one sample is dropped by the median
+    for (int c = 0; c < NUM_AXIS; c++) {
+        FILTER_avgPush(&average[c], FILTER_medianPush(&median[c], sensorData[c]));
+        filtered.axis[c] = FILTER_avgGet(&average[c]);
+    }
+    filtered.ticks = ticks;
+    filtered.count = average[0].count;
+    filtered.seq = slot.seq;
+}
+
+// get average of MAG_NUM_READINGS
 void MAG_AvgData(int32_t* avgData) {
     memset(avgData, 0, NUM_AXIS * sizeof(avgData[0]));
-    int16_t sensorData[NUM_AXIS] = {0};
+    struct SensorSample sample;
+    sample.seq = 0;
     
-    // O(NUM_READINGS * NUM_AXIS) = constant time
-    for (int i = 0; i < NUM_READINGS; i++) {
-        MAG_Data(sensorData);
+    // MAG_NUM_READINGS distinct samples => 0.2 sec at 50 Hz
+    // O(MAG_NUM_READINGS * NUM_AXIS) = constant time
+    for (int i = 0; i < MAG_NUM_READINGS; i++) {
+        int ms = 0;
+        while (!MAG_getSample(&sample) && ms < MAG_SAMPLE_TIMEOUT_MS) {
+            __delay_ms(1);
+            ms++;
+        }
+        if (ms >= MAG_SAMPLE_TIMEOUT_MS) {
+            MAG_Data(sample.axis);
+        }
         for (int j = 0; j < NUM_AXIS; j++) {
-            avgData[j] += sensorData[j];
+            avgData[j] += sample.axis[j];
         }
     }
     
     // O(NUM_AXIS) = constant time
     for (int c = 0; c < NUM_AXIS; c++) {
-        avgData[c] /= NUM_READINGS;
+        avgData[c] /= MAG_NUM_READINGS;
     }
 }
 
@@ -143,13 +208,26 @@ void MAG_AvgData(int32_t* avgData) {
     where D = angle
 */
 int MAG_Angle(void) {
-    // read current [x,y,z] sensor reading
-    int16_t sensorData[NUM_AXIS] = {0};
-    MAG_Data(sensorData);
+    // filtered state => updated by MAG_ISR() on every sample
+    struct SensorSample sample;
     
-    // get average of NUM_READINGS
-    //int32_t sensorData[NUM_AXIS] = {0};
-    //MAG_AvgData(sensorData);
+    if (!MAG_getFiltered(&sample)) {
+        // nothing filtered yet => wait for a sample DRDY delivers
+        int ms = 0;
+        while (!MAG_getSample(&sample) && ms < MAG_SAMPLE_TIMEOUT_MS) {
+            __delay_ms(1);
+            ms++;
+        }
+        if (ms >= MAG_SAMPLE_TIMEOUT_MS) {
+            // DRDY edge missed (pin stays high until OUT* is read)
+            // => read directly, which also re-arms DRDY
+            MAG_Data(sample.axis);
+        }
+    }
+    int16_t* sensorData = sample.axis;
+    
+    // soft iron => the hard iron is already removed by the sensor
+    MAGCAL_correct(sensorData);
 
 #ifdef DEBUG
     // send axis data to Raspberry Pi
@@ -162,24 +240,30 @@ int MAG_Angle(void) {
     // calculate angle from x,y,z readings
     // quadrant-aware arctan(y/x)
     // => see: https://arduino.stackexchange.com/questions/18625/converting-three-axis-magnetometer-to-degrees
-    float angle = atan2(sensorData[1], sensorData[0]);
+    // => binary angle, see fixmath.h
+    int16_t angle = FX_atan2(sensorData[1], sensorData[0]);
     
 #ifdef DEBUG
     char rawAngle[20];
-    sprintf(rawAngle, "Raw angle: %f\n", angle);
+    sprintf(rawAngle, "Raw angle: %d\n", angle);
     UART_send_str(rawAngle);
     __delay_ms(100);
 #endif /* DEBUG */
     
-    // convert from rad to deg
-    int angleDegrees = (int)(angle * (180/M_PI));
-    
 #ifdef DEBUG
     char degStr[20];
-    sprintf(degStr, "%d degrees\n", angleDegrees);
+    sprintf(degStr, "%d degrees\n", FX_BAM_TO_DEG(angle));
     UART_send_str(degStr);
 #endif /* DEBUG */
     
+    return MAG_Azimuth(angle);
+}
+
+/* heading of the sensor's x axis => azimuth in degrees */
+int MAG_Azimuth(int16_t angle) {
+    // convert from binary angle to deg
+    int angleDegrees = FX_BAM_TO_DEG(angle);
+    
     // map (-180, 180] to [0, 360]
     // Note: angles given by atan2() in [0, 180] should remain as is,
     //       the negative angles correspond to (180, 360] on the euclidean plane
@@ -189,27 +273,54 @@ int MAG_Angle(void) {
     // 3. 0 and 360     => when 360, will return 0
     angleDegrees = (angleDegrees + 360) % 360;
     
-    return ((360 + angleDegrees) - (int)DECLINATION - initialOff) % 360;  
+    return ((720 + angleDegrees) - (int)DECLINATION - MAG_MOUNT_OFFSET) % 360;  
 }
 
 /* initialize magnetometer module */
 int Mag_Initialize(void) {
-    // temp compensation enabled
-    // high-res mode, 10Hz output data rate, continuous measurement mode
+    // hard-iron offsets, low-pass filter, offset cancellation and
+    // CFG_REG_A (default: temp compensation, high-res mode, 50Hz output
+    // data rate, continuous measurement mode) from the calibration profile
     // => turn-on time: ~9.4 ms 
-    MAG_Write(CFG_REG_A, 0x80);
+    SENSORCFG_applyMag();
     __delay_ms(10);
     
     // SPI mode only, avoid reading incorrect data pin set, 4 wire SPI mode
-    // disable self-test, data-ready pin off since continuous mode
-    MAG_Write(CFG_REG_C, 0x34);
+    // disable self-test, data-ready signal on the DRDY pin
+    MAG_Write(CFG_REG_C, 0x35);
+    
+    // fastest SPI clock that reads WHO_AM_I back => 4-wire from here on
+    SPI_tune(MAGNETOMETER, REGBUS_command(&bus, WHO_AM_I, REGBUS_READ, 1), WHO_AM_I_VAL);
     
     // return 0 if incorrect device id
     if (Get_MAG_ID() != WHO_AM_I_VAL) 
         return 0;
     
-    //point south to begin with
-    initialOff = (int16_t)MAG_Angle() - 180;
+    // DRDY pin => RB2/INT2 on the rising edge, low priority (uses SPI)
+    memset((void *)&slot, 0, sizeof(slot));
+    memset((void *)&filtered, 0, sizeof(filtered));
+    for (int c = 0; c < NUM_AXIS; c++) {
+        FILTER_medianInit(&median[c]);
+        FILTER_avgInit(&average[c], MAG_FILTER_LEN);
+    }
+    readCmd = REGBUS_command(&bus, OUTX_L_REG, REGBUS_READ, sizeof(readRaw));
+    readOut.slave = MAGNETOMETER;
+    readOut.tx = &readCmd;
+    readOut.txLen = 1;
+    readOut.rx = readRaw;
+    readOut.rxLen = sizeof(readRaw);
+    readOut.complete = MAG_ReadDone;
+    readOut.done = 1;
+    MAG_DRDY_PIN = 1;               // input
+    INTCON2bits.INTEDG2 = 1;
+    INTCON3bits.INT2IP = 0;
+    INTCON3bits.INT2IF = 0;
+    INTCON3bits.INT2IE = 1;
+    
+    // DRDY may already be high from a sample before INT2 was enabled
+    // => reading it out lets the next sample raise a fresh edge
+    int16_t discard[NUM_AXIS];
+    MAG_Data(discard);
     
     return 1;
 }
\ No newline at end of file
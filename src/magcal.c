@@ -0,0 +1,308 @@
+/**
+ * @file    magcal.c
+ * @author  Ali Choudhry, Mustafa Siddiqui
+ * @brief   Function definitions for magnetometer calibration.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "../inc/magcal.h"
+#include "../inc/mag.h"         // MAG_getSample()
+#include "../inc/motor.h"       // moveMotor(), stopMotor()
+#include "../inc/sensorcfg.h"   // SENSORCFG_*Profile()
+#include "../inc/eeprom.h"
+#include "../inc/fixmath.h"     // FX_atan2()
+//-//
+#include <xc.h>
+#include <math.h>   // sqrtf(), fabsf()
+#include <string.h> // memset(), memcpy()
+
+/* unknowns of the conic fit */
+#define FIT_N   5
+
+static struct MAGCAL_Record record;
+
+/* samples spanning the sweep => 256 bytes, only needed while calibrating */
+static int16_t samples[MAGCAL_SAMPLES][2];
+
+/* checksum over the matrix */
+static unsigned char MAGCAL_checksum(void) {
+    return EEPROM_checksum(record.softIron, sizeof(record.softIron));
+}
+
+/* identity => uncorrected readings */
+static void MAGCAL_setIdentity(void) {
+    record.softIron[0] = MAGCAL_ONE;
+    record.softIron[1] = 0;
+    record.softIron[2] = 0;
+    record.softIron[3] = MAGCAL_ONE;
+}
+
+/* load the stored matrix */
+int initMagCal(void) {
+    EEPROM_readBlock(EE_ADDR_MAGCAL, &record, sizeof(record));
+    if (record.magic == MAGCAL_MAGIC && record.checksum == MAGCAL_checksum()) {
+        return 1;
+    }
+    MAGCAL_setIdentity();
+    return 0;
+}
+
+/* soft iron => [x, y] = W [x, y] */
+void MAGCAL_correct(int16_t *sensorData) {
+    int32_t x = sensorData[0];
+    int32_t y = sensorData[1];
+    sensorData[0] = (int16_t)((record.softIron[0] * x + record.softIron[1] * y) >> MAGCAL_Q);
+    sensorData[1] = (int16_t)((record.softIron[2] * x + record.softIron[3] * y) >> MAGCAL_Q);
+}
+
+/* solve a * p = b in place, Gaussian elimination with partial pivoting */
+static int MAGCAL_solve(float a[FIT_N][FIT_N], float *b) {
+    for (unsigned char col = 0; col < FIT_N; col++) {
+        unsigned char pivot = col;
+        for (unsigned char r = col + 1; r < FIT_N; r++) {
+            if (fabsf(a[r][col]) > fabsf(a[pivot][col])) {
+                pivot = r;
+            }
+        }
+        if (fabsf(a[pivot][col]) < 1e-6f) {
+            return 0;   // samples don't pin down an ellipse
+        }
+        if (pivot != col) {
+            for (unsigned char c = 0; c < FIT_N; c++) {
+                float t = a[col][c];
+                a[col][c] = a[pivot][c];
+                a[pivot][c] = t;
+            }
+            float t = b[col];
+            b[col] = b[pivot];
+            b[pivot] = t;
+        }
+        for (unsigned char r = col + 1; r < FIT_N; r++) {
+            float f = a[r][col] / a[col][col];
+            for (unsigned char c = col; c < FIT_N; c++) {
+                a[r][c] -= f * a[col][c];
+            }
+            b[r] -= f * b[col];
+        }
+    }
+
+    // back substitution
+    for (signed char r = FIT_N - 1; r >= 0; r--) {
+        float sum = b[r];
+        for (unsigned char c = r + 1; c < FIT_N; c++) {
+            sum -= a[r][c] * b[c];
+        }
+        b[r] = sum / a[r][r];
+    }
+    return 1;
+}
+
+/* ellipse through the samples */
+int MAGCAL_fit(const int16_t (*xy)[2], unsigned char n, struct MAGCAL_Fit *fit) {
+    float a[FIT_N][FIT_N];
+    float p[FIT_N];
+    float row[FIT_N];
+
+    if (n < FIT_N) {
+        return 0;
+    }
+
+    // centre and scale by the bounding box => u, v in about [-1, 1]
+    int16_t xmin = xy[0][0], xmax = xy[0][0];
+    int16_t ymin = xy[0][1], ymax = xy[0][1];
+    for (unsigned char i = 1; i < n; i++) {
+        if (xy[i][0] < xmin) xmin = xy[i][0];
+        if (xy[i][0] > xmax) xmax = xy[i][0];
+        if (xy[i][1] < ymin) ymin = xy[i][1];
+        if (xy[i][1] > ymax) ymax = xy[i][1];
+    }
+    float cx0 = ((float)xmin + xmax) / 2;
+    float cy0 = ((float)ymin + ymax) / 2;
+    float r0 = ((float)xmax - xmin > (float)ymax - ymin) ? ((float)xmax - xmin) / 2 : ((float)ymax - ymin) / 2;
+    if (r0 < MAGCAL_MIN_RADIUS) {
+        return 0;
+    }
+
+    // normal equations => sum(row row^T) p = sum(row)
+    memset(a, 0, sizeof(a));
+    memset(p, 0, sizeof(p));
+    for (unsigned char i = 0; i < n; i++) {
+        float u = (xy[i][0] - cx0) / r0;
+        float v = (xy[i][1] - cy0) / r0;
+        row[0] = u * u;
+        row[1] = u * v;
+        row[2] = v * v;
+        row[3] = u;
+        row[4] = v;
+        for (unsigned char r = 0; r < FIT_N; r++) {
+            for (unsigned char c = r; c < FIT_N; c++) {
+                a[r][c] += row[r] * row[c];
+            }
+            p[r] += row[r];
+        }
+    }
+    for (unsigned char r = 1; r < FIT_N; r++) {
+        for (unsigned char c = 0; c < r; c++) {
+            a[r][c] = a[c][r];
+        }
+    }
+    if (!MAGCAL_solve(a, p)) {
+        return 0;
+    }
+
+    // quadratic part M = [A, B/2; B/2, C] must be positive definite
+    float A = p[0], B2 = p[1] / 2, C = p[2];
+    float det = A * C - B2 * B2;
+    if (A <= 0 || det <= 0) {
+        return 0;
+    }
+
+    // centre => 2 M c = -[D, E]
+    float cu = -(C * p[3] - B2 * p[4]) / (2 * det);
+    float cv = -(A * p[4] - B2 * p[3]) / (2 * det);
+
+    // around its centre the ellipse is q^T (M / k) q = 1
+    float k = 1 + A * cu * cu + 2 * B2 * cu * cv + C * cv * cv;
+    if (k <= 0) {
+        return 0;
+    }
+    A /= k;
+    B2 /= k;
+    C /= k;
+    det /= k * k;
+
+    // axis ratio from the eigenvalues of M / k
+    float tr = A + C;
+    float disc = sqrtf(tr * tr / 4 - det);
+    float lmax = tr / 2 + disc;
+    float lmin = tr / 2 - disc;
+    if (lmin <= 0 || lmax > lmin * MAGCAL_MAX_RATIO * MAGCAL_MAX_RATIO) {
+        return 0;
+    }
+
+    // W = R sqrt(M / k) maps the ellipse onto a circle of radius R, the
+    // geometric mean of its semi-axes => det(W) = 1, the field keeps its size
+    // sqrt of a 2x2 SPD matrix: (M + sqrt(det) I) / sqrt(tr + 2 sqrt(det))
+    float s = sqrtf(det);
+    float t = sqrtf(tr + 2 * s);
+    float R = 1 / sqrtf(s);
+    float w00 = R * (A + s) / t;
+    float w01 = R * B2 / t;
+    float w11 = R * (C + s) / t;
+
+    fit->center[0] = (int16_t)(cx0 + r0 * cu + (cx0 + r0 * cu < 0 ? -0.5f : 0.5f));
+    fit->center[1] = (int16_t)(cy0 + r0 * cv + (cy0 + r0 * cv < 0 ? -0.5f : 0.5f));
+    fit->softIron[0] = (int16_t)(w00 * MAGCAL_ONE + 0.5f);
+    fit->softIron[1] = (int16_t)(w01 * MAGCAL_ONE + (w01 < 0 ? -0.5f : 0.5f));
+    fit->softIron[2] = fit->softIron[1];
+    fit->softIron[3] = (int16_t)(w11 * MAGCAL_ONE + 0.5f);
+    fit->radius = (int16_t)(R * r0 + 0.5f);
+
+    // quality => rms of (|W q| - R) over the samples, as the firmware applies it
+    float sq = 0;
+    for (unsigned char i = 0; i < n; i++) {
+        int32_t x = xy[i][0] - fit->center[0];
+        int32_t y = xy[i][1] - fit->center[1];
+        float cxq = (float)((fit->softIron[0] * x + fit->softIron[1] * y) >> MAGCAL_Q);
+        float cyq = (float)((fit->softIron[2] * x + fit->softIron[3] * y) >> MAGCAL_Q);
+        float e = sqrtf(cxq * cxq + cyq * cyq) - R * r0;
+        sq += e * e;
+    }
+    float residual = 100 * sqrtf(sq / n) / (R * r0);
+    fit->residual = (residual > 255) ? 255 : (unsigned char)(residual + 0.5f);
+
+    return fit->residual <= MAGCAL_MAX_RESIDUAL;
+}
+
+/* sweep, fit, store */
+int MAGCAL_run(void) {
+    struct SensorSample sample;
+    struct MAGCAL_Fit fit;
+    struct SENSORCFG_Profile profile;
+    unsigned char n = 0, step = 1, skip = 0;
+    int16_t xmin = 0, xmax = 0, ymin = 0, ymax = 0;
+    int16_t lastAngle = 0;
+    unsigned char tracking = 0;
+    unsigned char first = 1;
+    int32_t turned = 0;
+    unsigned int ms = 0, seconds = 0;
+
+    sample.seq = 0;
+    moveMotor(MAGCAL_SWEEP_SPEED, MAGCAL_SWEEP_DIR, HORIZONTAL);
+
+    while (turned < MAGCAL_TURN && turned > -MAGCAL_TURN && seconds < MAGCAL_TIMEOUT_S) {
+        if (!MAG_getSample(&sample)) {
+            __delay_ms(1);
+            if (++ms == 1000) {
+                ms = 0;
+                seconds++;
+            }
+            continue;
+        }
+        int16_t x = sample.axis[0];
+        int16_t y = sample.axis[1];
+
+        // keep every step-th sample, thin out when full
+        if (++skip >= step) {
+            skip = 0;
+            if (n == MAGCAL_SAMPLES) {
+                for (unsigned char i = 0; i < MAGCAL_SAMPLES / 2; i++) {
+                    samples[i][0] = samples[2 * i][0];
+                    samples[i][1] = samples[2 * i][1];
+                }
+                n = MAGCAL_SAMPLES / 2;
+                step *= 2;
+            }
+            samples[n][0] = x;
+            samples[n][1] = y;
+            n++;
+        }
+
+        // bounding box => running centre for counting the turn
+        if (first) {
+            xmin = xmax = x;
+            ymin = ymax = y;
+            first = 0;
+        }
+        if (x < xmin) xmin = x;
+        if (x > xmax) xmax = x;
+        if (y < ymin) ymin = y;
+        if (y > ymax) ymax = y;
+        if ((xmax - xmin) / 2 < MAGCAL_MIN_RADIUS || (ymax - ymin) / 2 < MAGCAL_MIN_RADIUS) {
+            continue;
+        }
+
+        // binary angles wrap, so the 16-bit difference is the step taken
+        int16_t angle = FX_atan2(y - (ymin + ymax) / 2, x - (xmin + xmax) / 2);
+        if (tracking) {
+            turned += (int16_t)(angle - lastAngle);
+        }
+        lastAngle = angle;
+        tracking = 1;
+    }
+    stopMotor(HORIZONTAL);
+
+    if (turned < MAGCAL_TURN && turned > -MAGCAL_TURN) {
+        return -1;  // never made it round
+    }
+    if (!MAGCAL_fit((const int16_t (*)[2])samples, n, &fit)) {
+        return -1;
+    }
+
+    // hard iron => the sensor already subtracts the old offsets
+    SENSORCFG_getProfile(&profile);
+    profile.magOffset[0] += fit.center[0];
+    profile.magOffset[1] += fit.center[1];
+    SENSORCFG_setProfile(&profile);
+
+    // soft iron => applied by MAG_Angle()
+    memcpy(record.softIron, fit.softIron, sizeof(record.softIron));
+    record.magic = MAGCAL_MAGIC;
+    record.checksum = MAGCAL_checksum();
+    EEPROM_writeBlock(EE_ADDR_MAGCAL, &record, sizeof(record));
+
+    return fit.residual;
+}
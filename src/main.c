@@ -9,11 +9,22 @@
  */
 
 #include "../inc/init.h"
+#include "../inc/isr.h"
 #include "../inc/uart.h"
 #include "../inc/spi.h"
 #include "../inc/accel.h"
 #include "../inc/mag.h"
+#include "../inc/sensorcfg.h"
+#include "../inc/magcal.h"
+#include "../inc/orient.h"
+#include "../inc/vibe.h"
 #include "../inc/gps.h"
+#include "../inc/gpscfg.h"
+#include "../inc/gpsaid.h"
+#include "../inc/ephem.h"
+#include "../inc/rtc.h"
+#include "../inc/clkcal.h"
+#include "../inc/fixmath.h"
 #include "../inc/motor.h"
 //-//
 #include <xc.h>
@@ -28,13 +39,17 @@
 #define ALLOWED_ERROR           2
 #define HORIZONTAL_TIME_CONST   5
 #define VERTICAL_POWER_CONST    10
+#define STOW_MIN_SPEED          100
+#define STOW_TIMEOUT_MS         60000
 
 /* Logic Control Functions */
 int move_vertical_to_angle(int target_angle);
 int move_horizontal_to_angle(int target_angle);
+int stow(void);
 void error(void);
 void variableMsDelay(int num);
 void minuteDelay(int minutes);
+void serviceGPS(void);
 
 int main(void) {
     // set clock freq to 8 MHz
@@ -43,6 +58,9 @@ int main(void) {
     // set all pins as digital output
     initPins();
     
+    // enable interrupts => UART RX/TX run from the ISR from here on
+    initInterrupts();
+    
     // turn on LEDs to indicate start of init process
     ERROR_LIGHT = 1;
     __delay_ms(1000);
@@ -61,6 +79,9 @@ int main(void) {
     __delay_ms(500);
 #endif /* DEBUG */
     
+    // sensor offsets/filters => programmed by initAccel() and Mag_Initialize()
+    initSensorConfig();
+    
     // initialize accelerometer module
     if (!initAccel()) {
         // try for NUM_TRIES otherwise go into error state
@@ -75,7 +96,7 @@ int main(void) {
 #endif /* DEBUG */
     __delay_ms(500);
     
-    /* initialize magnetometer module
+    // initialize magnetometer module
     if (!Mag_Initialize()) {
         // try for NUM_TRIES otherwise go into error state
         for (int tries = 0; tries < NUM_TRIES; tries++) {
@@ -83,7 +104,7 @@ int main(void) {
                 break;
             error();
         }
-    }*/ 
+    }
 #ifdef DEBUG
     UART_send_str("Mag initialized...\n");
     __delay_ms(500);
@@ -96,25 +117,104 @@ int main(void) {
     __delay_ms(500);
 #endif /* DEBUG */
     
+    // no stored magnetometer calibration => sweep a turn to make one
+    if (!initMagCal()) {
+#ifdef DEBUG
+        char calStr[32];
+        sprintf(calStr, "Mag cal residual: %d%%\n", MAGCAL_run());
+        UART_send_str(calStr);
+#else
+        MAGCAL_run();
+#endif /* DEBUG */
+    }
+    
+    // track orientation from the (now calibrated) sensors
+    initOrient();
+    
+    // start the real-time clock => set from the first GPS fix
+    initRTC();
+    
+    // SPI busy time is counted on Timer1 => bytes before now had none
+    SPI_resetStats(ACCELEROMETER);
+    SPI_resetStats(MAGNETOMETER);
+#ifdef DEBUG
+    {
+        // SPI time per accelerometer sample, Timer1 ticks are 4 us
+        int16_t sample[NUM_AXIS];
+        char str[40];
+        uint32_t start = RTC_getTicks();
+        for (int i = 0; i < ACCEL_NUM_READINGS; i++) {
+            _ACCEL_getCurrentReading(sample);
+        }
+        sprintf(str, "Accel sample: %lu us\n", (unsigned long)((RTC_getTicks() - start) * 4 / ACCEL_NUM_READINGS));
+        UART_send_str(str);
+        
+        // clock kept by SPI_tune() and the IDs read at each one
+        struct SPI_Stats spi;
+        SPI_getStats(ACCELEROMETER, &spi);
+        sprintf(str, "Accel SPI: %u B/ms SSPM %u (%02X)\n", SPI_getThroughput(ACCELEROMETER), spi.speed, spi.passed);
+        UART_send_str(str);
+        SPI_getStats(MAGNETOMETER, &spi);
+        sprintf(str, "Mag SPI: %u B/ms SSPM %u (%02X)\n", SPI_getThroughput(MAGNETOMETER), spi.speed, spi.passed);
+        UART_send_str(str);
+    }
+#endif /* DEBUG */
+    
+    // trim the internal oscillator against the GPS 1PPS once it has a fix
+    initClockCal();
+    
+    // warm start the EM506 from the last saved fix
+    // => must go out before initGPSConfig() raises the baud rate
+    initGPSAid();
+    
+    // cut the EM506 down to the sentences we use
+    initGPSConfig();
+    
+    // load the last solar ephemeris table from EEPROM
+    EPHEM_init();
+    
     // turn off LED to indicate end of init process
     ERROR_LIGHT = 0;
     __delay_ms(1000);
     
-    float float_angles[2] = {0};
+    struct TimePos time_pos;
+    int16_t fx_angles[2] = {0};
     int int_angles[2] = {0};
+    int stowed = 0;
     while(1) {
-        // get target angles and convert to integer type
-        get_target_angles(float_angles);
-        int_angles[0] = (int) float_angles[0];
-        int_angles[1] = (int) float_angles[1];
+        // GPS is only needed to set the clock the first time
+        while (!RTC_isValid()) {
+            serviceGPS();
+        }
+        
+        // time from the RTC, position from the last fix
+        // => rebuild the ephemeris at the first cycle of the day
+        RTC_getTimePos(&time_pos);
+        EPHEM_update(&time_pos);
+        
+        // get target angles and convert to integer degrees
+        if (!EPHEM_getAngles(&time_pos, fx_angles)) {
+            calculate_target_angles_fx(time_pos, fx_angles);
+        }
+        // => azimuth in [0, 360), the afternoon sun is 180-270 deg
+        int_angles[0] = FX_BAM_TO_DEG(fx_angles[0]);
+        int_angles[1] = FX_BAM_TO_DEG360(fx_angles[1]);
+        
+        // too much wind => lie flat until it has died down
+        if (VIBE_isWindy()) {
+            if (!stowed && stow()) {
+                error();
+            }
+            stowed = 1;
+        } else {
+            stowed = 0;
+        }
     
-        if (int_angles[0] < 80){ // if the sun is high enough
-            /*
+        if (!stowed && int_angles[0] < 80){ // if the sun is high enough
             __delay_ms(1000);
             if (move_horizontal_to_angle(int_angles[1]) ){
                 error();
             }
-            */
             __delay_ms(1000);
             if (move_vertical_to_angle(int_angles[0]) ) {
                 error();
@@ -142,9 +242,21 @@ int move_horizontal_to_angle(int target_angle){
     int error;
     
     do {
-        __delay_ms(200);
+        // stow takes over in the main loop
+        if (VIBE_isWindy()) {
+            return 0;
+        }
+        
+        // measure once the structure has stopped swinging
+        ACCEL_waitSettled(serviceGPS);
          
-        current_angle = MAG_Angle();
+        // tilt-compensated => the panel is rarely level
+        struct ORIENT_Angles angles;
+        if (ORIENT_getEstimate(&angles)) {
+            current_angle = angles.azimuth;
+        } else {
+            current_angle = MAG_Angle();
+        }
         
 #ifdef DEBUG
         char curr_angle_str[20];
@@ -186,6 +298,9 @@ int move_horizontal_to_angle(int target_angle){
         variableMsDelay(time);
         stopMotor(HORIZONTAL); 
         
+        // the RX ring holds one burst of RMC + GGA => drain it every step
+        serviceGPS();
+        
         cycles ++;
     } while (cycles < MAX_CYCLES);
     
@@ -215,13 +330,30 @@ int move_vertical_to_angle(int target_angle) {
     int direction;
     
     do {
-        __delay_ms(500);
+        // stow takes over in the main loop
+        if (VIBE_isWindy()) {
+            return 0;
+        }
         
-        // measure current angle
-        current_angle = getCurrentZenith();
+        // measure once the structure has stopped swinging
+        // => no more than ACCEL_SETTLE_TIMEOUT_MS, then measure anyway
+#ifdef DEBUG
+        char str[20];
+        sprintf(str, "Settle: %d ms\n", ACCEL_waitSettled(serviceGPS));
+        UART_send_str(str);
+#else
+        ACCEL_waitSettled(serviceGPS);
+#endif /* DEBUG */
+        
+        // measure current angle => tracked estimate once there is one
+        struct ORIENT_Angles angles;
+        if (ORIENT_getEstimate(&angles)) {
+            current_angle = angles.zenith;
+        } else {
+            current_angle = getCurrentZenith();
+        }
         
 #ifdef DEBUG
-        char str[10];
         sprintf(str, "CA: %d\n", current_angle);
         UART_send_str(str);
 #endif /* DEBUG */
@@ -303,6 +435,9 @@ int move_vertical_to_angle(int target_angle) {
         variableMsDelay(time);
         stopMotor(VERTICAL);    
         
+        // the RX ring holds one burst of RMC + GGA => drain it every step
+        serviceGPS();
+        
         last_error = error;
         cycles++;
     } while (cycles < MAX_CYCLES);
@@ -310,6 +445,59 @@ int move_vertical_to_angle(int target_angle) {
     return 0;
 }
 
+/* lay the panel flat (zenith 0) => least area facing the wind */
+int stow(void) {
+    struct VIBE_Stats stats;
+    struct ORIENT_Angles angles;
+    int current_angle;
+    int speed;
+    int ms = 0;
+    
+    VIBE_getStats(&stats);
+#ifdef DEBUG
+    char str[40];
+    sprintf(str, "Stow: rms %u amp %u\n", stats.rms, stats.amp[stats.dominant]);
+    UART_send_str(str);
+#endif /* DEBUG */
+    
+    // the structure is swinging => no waiting for it to settle, short
+    // steps on the tracked estimate instead (the direct reading once
+    // the estimate has gone ORIENT_MAX_COAST blocks uncorrected)
+    while (ms < STOW_TIMEOUT_MS) {
+        if (ORIENT_getEstimate(&angles)) {
+            current_angle = angles.zenith;
+        } else {
+            current_angle = getCurrentZenith();
+        }
+        
+        // validate the current angle
+        if (current_angle < -90 || current_angle > 90) {
+            stopMotor(VERTICAL);
+            return 1;
+        }
+        
+        if (abs(current_angle) <= ALLOWED_ERROR) {
+            stopMotor(VERTICAL);
+            return 0;
+        }
+        
+        // towards zenith 0 => the "up" formula of move_vertical_to_angle()
+        speed = VERTICAL_POWER_CONST * abs(current_angle);
+        if (speed < STOW_MIN_SPEED) {
+            speed = STOW_MIN_SPEED;
+        } else if (speed > 500) {
+            speed = 500;
+        }
+        moveMotor(speed, (current_angle > 0) ? COUNTER_CLOCKWISE : CLOCKWISE, VERTICAL);
+        __delay_ms(50);
+        ms += 50;
+        serviceGPS();
+    }
+    
+    stopMotor(VERTICAL);
+    return 1;
+}
+
 /* enter into error state: flash error LED infinitely */
 void error() {
     // keep on flashing error LED until users shuts power
@@ -327,8 +515,60 @@ void variableMsDelay(int num) {
         __delay_ms(1);
 }
 
-/* delay for some # of minutes */
+/* delay for some # of minutes, cut short by wind */
 void minuteDelay(int min) {
-    for (int i = 0; i < min*60; i++)
-        __delay_ms(1000);
+    // already stowed => sit out the whole delay
+    int windy = VIBE_isWindy();
+    
+    // keep draining GPS data so the UART RX ring doesn't overflow
+    for (int i = 0; i < min*600; i++) {
+        __delay_ms(100);
+        serviceGPS();
+        if (!windy && VIBE_isWindy()) {
+            return;
+        }
+    }
+}
+
+/* resync the RTC from GPS when due, never waits for a sentence */
+void serviceGPS(void) {
+    struct TimePos fix;
+    
+    // keep the oscillator (and so delays, PWM and baud rate) on frequency
+    CLKCAL_service();
+    
+    while (poll_time_pos(&fix)) {
+        if (!RTC_isValid() || RTC_getSecondsSinceSync() >= RTC_RESYNC_S) {
+            RTC_sync(&fix);
+        }
+        
+        // first fix is saved at once, then every GPSAID_SAVE_S
+#ifdef DEBUG
+        if (GPSAID_fix(&fix)) {
+            unsigned char aided;
+            char str[40];
+            unsigned int ttff = GPSAID_getTTFF(&aided);
+            sprintf(str, "GPS TTFF: %u s (%s)\n", ttff, aided ? "aided" : "cold");
+            UART_send_str(str);
+        }
+#else
+        GPSAID_fix(&fix);
+#endif /* DEBUG */
+    }
+    
+    // (re)configure the receiver's sentences, verifies from traffic seen
+#ifdef DEBUG
+    static int gpscfgState = GPSCFG_MEASURE_DEFAULT;
+    int state = GPSCFG_service();
+    if (state == GPSCFG_CONFIGURED && gpscfgState != GPSCFG_CONFIGURED) {
+        struct GPSCFG_Report report;
+        char str[48];
+        GPSCFG_getReport(&report);
+        sprintf(str, "GPS bytes/fix: %u -> %u @ %lu\n", report.bytes_per_fix_before, report.bytes_per_fix_after, report.baud);
+        UART_send_str(str);
+    }
+    gpscfgState = state;
+#else
+    GPSCFG_service();
+#endif /* DEBUG */
 }
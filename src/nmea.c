@@ -0,0 +1,778 @@
+/**
+ * @file    nmea.c
+ * @author  Carter Bordeleau, Mustafa Siddiqui
+ * @brief   Function definitions for decoding NMEA sentences. No xc.h or
+ *          UART dependency, so this file also builds on a host compiler.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "../inc/nmea.h"
+//-//
+#include <string.h> // memset(), strncmp()
+#include <stdlib.h> // atof()
+
+/*
+ * run the streaming parser over a string holding one sentence
+ * return 1 and fill *tp if it is a valid RMC with a usable position
+ * => stops at the terminating '\0' or after NMEA_MAX_LEN chars
+ */
+static int parse_sentence(const char* str, struct TimePos* tp) {
+    struct NMEA_Parser parser;
+
+    if (!is_GPRMC(str)) {
+        return 0;
+    }
+
+    init_NMEA_Parser(&parser);
+    for (unsigned char i = 0; i < NMEA_MAX_LEN && str[i] != '\0'; i++) {
+        if (parse_NMEA_char(&parser, str[i], tp)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * given NMEA GPRMC string
+ * return a timePos object that represents time, latitude and longitude
+ * => all zero if the string is not a valid GPRMC, see is_Valid_GPRMC()
+ */
+struct TimePos parse_GPRMC(const char* input_str) {
+    struct TimePos timePosobj;
+
+    if (!parse_sentence(input_str, &timePosobj)) {
+        memset(&timePosobj, 0, sizeof(timePosobj));
+    }
+    return timePosobj;
+}
+
+/*
+ * return 1 if the input string starts with "$xxRMC", any talker ID
+ */
+int is_GPRMC(const char* str){
+    return str[0] == '$' && str[1] != '\0' && str[2] != '\0' && !strncmp(str + 3, "RMC", 3);
+}
+
+/*
+ * days in each month of a common year
+ */
+static const unsigned char days_in_month[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+/*
+ * return the ordinal date of a string in DDMMYY format, 0 if malformed
+ * or the day is past the end of its month
+ */
+int str_to_ordinal_date(char* str) {
+    for (int i = 0; i < 6; i++) {
+        if (str[i] < '0' || str[i] > '9') {
+            return 0;
+        }
+    }
+
+    //break up string into DD MM and YY
+    int DD = 10*(str[0] - '0') + (str[1] - '0');
+    int MM = 10*(str[2] - '0') + (str[3] - '0');
+    int YY = 10*(str[4] - '0') + (str[5] - '0');
+    
+    if (DD < 1 || MM < 1 || MM > 12) {
+        return 0;
+    }
+
+    int days_in_feb = 28;
+    int doy = DD;
+
+    // check for leap year
+    if( (YY % 4 == 0 && YY % 100 != 0 ) || (YY % 400 == 0) )
+    {
+        days_in_feb = 29;
+    }
+
+    if (DD > ((MM == 2) ? days_in_feb : days_in_month[MM - 1])) {
+        return 0;
+    }
+
+    switch(MM)
+    {
+        case 2:
+            doy += 31;
+            break;
+        case 3:
+            doy += 31+days_in_feb;
+            break;
+        case 4:
+            doy += 62+days_in_feb;
+            break;
+        case 5:
+            doy += 92+days_in_feb;
+            break;
+        case 6:
+            doy += 123+days_in_feb;
+            break;
+        case 7:
+            doy += 153+days_in_feb;
+            break;            
+        case 8:
+            doy += 184+days_in_feb;
+            break;
+        case 9:
+            doy += 215+days_in_feb;
+            break;
+        case 10:
+            doy += 245+days_in_feb;            
+            break;            
+        case 11:
+            doy += 276+days_in_feb;            
+            break;                        
+        case 12:
+            doy += 306+days_in_feb;            
+            break;                                    
+    }
+
+    return doy;
+}
+
+/*
+ * return minute of the day given string in hhmmss.ss format
+ */
+int str_to_minute(char* str) {
+    return 600* (str[0] - '0') + 60* (str[1] - '0') + 10* (str[2] - '0') + (str[3] - '0');
+}
+
+/*
+ * return latitude given string in DDmm.mm format
+ */
+float str_to_latitude(char* str) {
+    return (float)(atof(str) / 100);
+}
+
+/*
+ * return longitude given string in DDDmm.mm format
+ */
+float str_to_longitude(char* str) {
+    return (float)(atof(str) / 100);
+}
+
+/*
+ * return 1 if the input string is able to be parsed
+ * => checksum (either hex case), status 'A', mode not 'N' and every
+ *    field that parse_GPRMC() uses present and well formed
+ */
+int is_Valid_GPRMC(char* str){
+    struct TimePos tp;
+
+    return parse_sentence(str, &tp);
+}
+
+/*
+ * calculates the NMEA Checksum for a given string
+ */
+int calc_NMEA_Checksum( char *buf, int cnt )
+{
+    char Character;
+    int Checksum = 0;
+    int i;              // loop counter
+
+
+
+    //for each(char Character in sentence)
+    for (i=0;i<cnt;++i)
+    {
+        Character = buf[i];
+        switch(Character)
+        {
+            case '$':
+                // Ignore the dollar sign
+                break;
+            case '*':
+                // Stop processing before the asterisk
+                i = cnt;
+                continue;
+            default:
+                // Is this the first value for the checksum?
+                if (Checksum == 0)
+                {
+                    // Yes. Set the checksum to the value
+                    Checksum = Character;
+                }
+                else
+                {
+                    // No. XOR the checksum with this character's value
+                    Checksum = Checksum ^ Character;
+                }
+                break;
+        }
+    }
+
+    // Return the checksum
+    return (Checksum);
+
+}
+
+
+/* parser states */
+#define NMEA_WAIT_START 0   //waiting for '$'
+#define NMEA_FIELDS     1   //inside the sentence body
+#define NMEA_CHECK_HI   2   //expecting first checksum digit
+#define NMEA_CHECK_LO   3   //expecting second checksum digit
+
+/* RMC fields, numbered as they appear after the address field */
+#define RMC_TIME        1
+#define RMC_STATUS      2
+#define RMC_LAT         3
+#define RMC_LAT_DIR     4
+#define RMC_LON         5
+#define RMC_LON_DIR     6
+#define RMC_DATE        9
+#define RMC_MODE        12
+
+/* GGA fields */
+#define GGA_TIME        1
+#define GGA_LAT         2
+#define GGA_LAT_DIR     3
+#define GGA_LON         4
+#define GGA_LON_DIR     5
+#define GGA_QUALITY     6
+#define GGA_SATS        7
+#define GGA_HDOP        8
+#define GGA_ALT         9
+
+/* ZDA fields */
+#define ZDA_TIME        1
+#define ZDA_DAY         2
+#define ZDA_MONTH       3
+#define ZDA_YEAR        4
+
+/* bits of NMEA_Parser.seen above the FIX_* bits, position needs all three */
+#define SEEN_LAT        0x0100
+#define SEEN_LON        0x0200
+#define SEEN_STATUS     0x0400  //RMC 'A' or GGA quality > 0
+#define SEEN_POS        (SEEN_LAT | SEEN_LON | SEEN_STATUS)
+#define SEEN_LAT_VALUE  0x0800  //value decoded, waiting for its hemisphere
+#define SEEN_LON_VALUE  0x1000
+
+/* fraction digits of the minutes that are used => 1e-6 min ~ 2 mm */
+#define NMEA_MINUTE_SCALE   1000000L
+
+static int decode_RMC_field(struct NMEA_Parser*);
+static int decode_GGA_field(struct NMEA_Parser*);
+static int decode_ZDA_field(struct NMEA_Parser*);
+
+/*
+ * sentences we decode, looked up once per sentence from the address field
+ * => anything else is dropped right there, its bytes are only counted
+ */
+static const struct {
+    char type[4];               //after the 2 char talker ID
+    unsigned char provides;     //FIX_* fields the sentence carries
+    int (*decode)(struct NMEA_Parser*);
+} sentence_table[] = {
+    {"RMC", FIX_TIME | FIX_DATE | FIX_POS, decode_RMC_field},
+    {"GGA", FIX_TIME | FIX_POS | FIX_QUALITY | FIX_SATS | FIX_HDOP | FIX_ALT, decode_GGA_field},
+    {"ZDA", FIX_TIME | FIX_DATE, decode_ZDA_field},
+};
+
+#define NUM_SENTENCES (sizeof(sentence_table) / sizeof(sentence_table[0]))
+
+/*
+ * return value of a hex digit, -1 if the char is not one
+ */
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/*
+ * return decimal degrees given a string in DDmm.mmmm (deg_digits = 2)
+ * or DDDmm.mmmm (deg_digits = 3) format, -1 if malformed
+ * => only a single float division, everything else is integer
+ * => minutes must be 2 digits and below 60; fraction digits finer
+ *    than NMEA_MINUTE_SCALE are ignored so 60 * scale fits a 32-bit long
+ */
+static float nmea_to_degrees(const char* str, unsigned char deg_digits) {
+    int degrees = 0;
+    long minutes = 0;       //minutes scaled by 'scale'
+    long scale = 1;
+    unsigned char digits = 0;   //minute digits before the decimal point
+    unsigned char frac = 0;     //set once the decimal point has been passed
+    unsigned char i;
+
+    for (i = 0; i < deg_digits; i++) {
+        if (str[i] < '0' || str[i] > '9') {
+            return -1;
+        }
+        degrees = 10*degrees + (str[i] - '0');
+    }
+    for (; str[i] != '\0'; i++) {
+        if (str[i] == '.' && !frac) {
+            frac = 1;
+            continue;
+        }
+        if (str[i] < '0' || str[i] > '9') {
+            return -1;
+        }
+        if (!frac) {
+            if (++digits > 2) {
+                return -1;
+            }
+        } else if (scale >= NMEA_MINUTE_SCALE) {
+            continue;
+        } else {
+            scale *= 10;
+        }
+        minutes = 10*minutes + (str[i] - '0');
+    }
+
+    if (digits != 2 || minutes >= 60 * scale) {
+        return -1;
+    }
+    return degrees + (float)minutes / (float)(60 * scale);
+}
+
+/*
+ * return a signed decimal string as an integer with 'places' decimals,
+ * extra decimals are truncated, return 0 in *ok if malformed
+ */
+static long nmea_to_fixed(const char* str, unsigned char places, unsigned char* ok) {
+    long value = 0;
+    unsigned char neg = (str[0] == '-');
+    unsigned char point = 0;    //set once the decimal point has been passed
+    unsigned char decimals = 0; //decimals taken so far
+
+    *ok = 0;
+    for (str += neg; *str != '\0'; str++) {
+        if (*str == '.' && !point) {
+            point = 1;
+            continue;
+        }
+        if (*str < '0' || *str > '9') {
+            return 0;
+        }
+        if (!point || decimals < places) {
+            value = 10*value + (*str - '0');
+            decimals += point;
+        }
+    }
+    for (; decimals < places; decimals++) {
+        value *= 10;
+    }
+
+    *ok = 1;
+    return neg ? -value : value;
+}
+
+/*
+ * hhmmss[.ss] time field, shared by all sentence types
+ * => hh 0-23, mm and ss 0-59, anything else drops the sentence
+ */
+static int decode_time(struct NMEA_Parser* p) {
+    const char* f = p->field_buf;
+
+    if (p->len < 6) {
+        return 0;
+    }
+    for (unsigned char i = 0; i < 6; i++) {
+        if (f[i] < '0' || f[i] > '9') {
+            return 0;
+        }
+    }
+    unsigned char hh = 10*(f[0] - '0') + (f[1] - '0');
+    unsigned char mm = 10*(f[2] - '0') + (f[3] - '0');
+    unsigned char ss = 10*(f[4] - '0') + (f[5] - '0');
+    if (hh > 23 || mm > 59 || ss > 59) {
+        return 0;
+    }
+    p->work.time = 60*hh + mm;
+    p->work.second = ss;
+    p->seen |= FIX_TIME;
+    return 1;
+}
+
+/*
+ * latitude or longitude value (deg_digits 2 or 3), value is SEEN_LAT_VALUE
+ * or SEEN_LON_VALUE => the hemisphere that follows needs it
+ * => past 90 deg of latitude or 180 deg of longitude drops the sentence
+ */
+static int decode_coord(struct NMEA_Parser* p, float* coord, unsigned char deg_digits, unsigned int value) {
+    *coord = nmea_to_degrees(p->field_buf, deg_digits);
+    if (*coord < 0 || *coord > ((deg_digits == 2) ? 90 : 180)) {
+        return 0;
+    }
+    p->seen |= value;
+    return 1;
+}
+
+/*
+ * hemisphere following a coordinate, neg is 'S' or 'W' and pos 'N' or 'E'
+ * => without the value (empty field) *coord is left over from an older
+ *    sentence, so it is neither touched nor marked as seen
+ */
+static int decode_hemisphere(struct NMEA_Parser* p, float* coord, char neg, char pos, unsigned int value, unsigned int seen) {
+    char c = p->field_buf[0] & ~0x20;   //upper case
+
+    if (c != neg && c != pos) {
+        return 0;
+    }
+    if (!(p->seen & value)) {
+        return 1;
+    }
+    if (c == neg) {
+        *coord = -*coord;
+    }
+    p->seen |= seen;
+    return 1;
+}
+
+/*
+ * decode an RMC field that was just terminated by ',' or '*'
+ * return 0 if the sentence has to be dropped
+ */
+static int decode_RMC_field(struct NMEA_Parser* p) {
+    const char* f = p->field_buf;
+
+    switch (p->field) {
+        case RMC_TIME:
+            return decode_time(p);
+        case RMC_STATUS:
+            //'V' = receiver warning, position is not usable
+            if (f[0] == 'A') {
+                p->seen |= SEEN_STATUS;
+            }
+            break;
+        case RMC_LAT:
+            return decode_coord(p, &p->work.latitude, 2, SEEN_LAT_VALUE);
+        case RMC_LAT_DIR:
+            return decode_hemisphere(p, &p->work.latitude, 'S', 'N', SEEN_LAT_VALUE, SEEN_LAT);
+        case RMC_LON:
+            return decode_coord(p, &p->work.longitude, 3, SEEN_LON_VALUE);
+        case RMC_LON_DIR:
+            return decode_hemisphere(p, &p->work.longitude, 'W', 'E', SEEN_LON_VALUE, SEEN_LON);
+        case RMC_DATE:
+            if (p->len != 6) {
+                return 0;
+            }
+            p->work.ordinal_date = str_to_ordinal_date(p->field_buf);
+            if (p->work.ordinal_date == 0) {
+                return 0;
+            }
+            p->work.year = 10*(f[4] - '0') + (f[5] - '0');
+            p->seen |= FIX_DATE;
+            break;
+        case RMC_MODE:
+            //NMEA 2.3 mode indicator, 'N' = data not valid
+            if (f[0] == 'N') {
+                p->seen &= ~SEEN_STATUS;
+            }
+            break;
+        default:
+            //speed, course and magnetic variation are not used
+            break;
+    }
+
+    return 1;
+}
+
+/*
+ * decode a GGA field that was just terminated by ',' or '*'
+ * return 0 if the sentence has to be dropped
+ */
+static int decode_GGA_field(struct NMEA_Parser* p) {
+    const char* f = p->field_buf;
+    unsigned char ok;
+    long value;
+
+    switch (p->field) {
+        case GGA_TIME:
+            return decode_time(p);
+        case GGA_LAT:
+            return decode_coord(p, &p->work.latitude, 2, SEEN_LAT_VALUE);
+        case GGA_LAT_DIR:
+            return decode_hemisphere(p, &p->work.latitude, 'S', 'N', SEEN_LAT_VALUE, SEEN_LAT);
+        case GGA_LON:
+            return decode_coord(p, &p->work.longitude, 3, SEEN_LON_VALUE);
+        case GGA_LON_DIR:
+            return decode_hemisphere(p, &p->work.longitude, 'W', 'E', SEEN_LON_VALUE, SEEN_LON);
+        case GGA_QUALITY:
+            if (f[0] < '0' || f[0] > '9') {
+                return 0;
+            }
+            p->work.quality = f[0] - '0';
+            p->seen |= FIX_QUALITY;
+            if (p->work.quality > 0) {
+                p->seen |= SEEN_STATUS;
+            }
+            break;
+        case GGA_SATS:
+            value = nmea_to_fixed(f, 0, &ok);
+            if (!ok || value < 0 || value > 255) {
+                return 0;
+            }
+            p->work.satellites = (unsigned char)value;
+            p->seen |= FIX_SATS;
+            break;
+        case GGA_HDOP:
+            value = nmea_to_fixed(f, 1, &ok);
+            if (!ok || value < 0 || value > 0xFFFF) {
+                return 0;
+            }
+            p->work.hdop = (unsigned int)value;
+            p->seen |= FIX_HDOP;
+            break;
+        case GGA_ALT:
+            p->work.altitude = nmea_to_fixed(f, 1, &ok);
+            if (!ok) {
+                return 0;
+            }
+            p->seen |= FIX_ALT;
+            break;
+        default:
+            //units, geoid separation and DGPS fields are not used
+            break;
+    }
+
+    return 1;
+}
+
+/*
+ * decode a ZDA field that was just terminated by ',' or '*'
+ * return 0 if the sentence has to be dropped
+ */
+static int decode_ZDA_field(struct NMEA_Parser* p) {
+    const char* f = p->field_buf;
+
+    switch (p->field) {
+        case ZDA_TIME:
+            return decode_time(p);
+        case ZDA_DAY:
+        case ZDA_MONTH:
+            if (p->len != 2) {
+                return 0;
+            }
+            //collect DDMM, the year completes the RMC style DDMMYY
+            memcpy(&p->date[2*(p->field - ZDA_DAY)], f, 2);
+            break;
+        case ZDA_YEAR:
+            if (p->len != 4) {
+                return 0;
+            }
+            //no day or month => the time is still good, the date is unset
+            if (p->date[0] == '\0' || p->date[2] == '\0') {
+                break;
+            }
+            p->date[4] = f[2];
+            p->date[5] = f[3];
+            p->work.ordinal_date = str_to_ordinal_date(p->date);
+            if (p->work.ordinal_date == 0) {
+                return 0;
+            }
+            p->work.year = 10*(f[2] - '0') + (f[3] - '0');
+            p->seen |= FIX_DATE;
+            break;
+        default:
+            //local zone is not used
+            break;
+    }
+
+    return 1;
+}
+
+/*
+ * look up the sentence type in the address field, any 2 letter talker ID
+ * return 0 if the sentence is not one we decode
+ */
+static int decode_address(struct NMEA_Parser* p) {
+    const char* f = p->field_buf;
+
+    if (p->len == 5 && f[0] >= 'A' && f[0] <= 'Z' && f[1] >= 'A' && f[1] <= 'Z') {
+        for (unsigned char i = 0; i < NUM_SENTENCES; i++) {
+            const char* type = sentence_table[i].type;
+            if (f[2] == type[0] && f[3] == type[1] && f[4] == type[2]) {
+                p->sentence = i + 1;
+                return 1;
+            }
+        }
+    }
+
+    p->stats.other++;
+    return 0;
+}
+
+/*
+ * copy the fields an intact sentence carried into the merged fix
+ */
+static void merge_fix(struct NMEA_Parser* p) {
+    unsigned char provides = sentence_table[p->sentence - 1].provides;
+    unsigned char seen = (unsigned char)p->seen;
+
+    if ((p->seen & SEEN_POS) == SEEN_POS) {
+        seen |= FIX_POS;
+    }
+
+    if (seen & FIX_TIME) {
+        p->fix.time = p->work.time;
+        p->fix.second = p->work.second;
+    }
+    if (seen & FIX_DATE) {
+        p->fix.ordinal_date = p->work.ordinal_date;
+        p->fix.year = p->work.year;
+    }
+    if (seen & FIX_POS) {
+        p->fix.latitude = p->work.latitude;
+        p->fix.longitude = p->work.longitude;
+    }
+    if (seen & FIX_QUALITY) {
+        p->fix.quality = p->work.quality;
+    }
+    if (seen & FIX_SATS) {
+        p->fix.satellites = p->work.satellites;
+    }
+    if (seen & FIX_HDOP) {
+        p->fix.hdop = p->work.hdop;
+    }
+    if (seen & FIX_ALT) {
+        p->fix.altitude = p->work.altitude;
+    }
+
+    //fields the sentence carries but left empty are no longer valid
+    p->fix.valid = (p->fix.valid & ~provides) | (seen & provides);
+}
+
+/*
+ * return 1 if the fix has a position good enough to point the panel with
+ * => quality, satellites and HDOP are only checked if GGA was received
+ */
+int NMEA_fix_usable(const struct NMEA_Fix* fix) {
+    if (!(fix->valid & FIX_POS)) {
+        return 0;
+    }
+    if ((fix->valid & FIX_QUALITY) && fix->quality == 0) {
+        return 0;
+    }
+    if ((fix->valid & FIX_SATS) && fix->satellites < NMEA_MIN_SATS) {
+        return 0;
+    }
+    if ((fix->valid & FIX_HDOP) && fix->hdop > NMEA_MAX_HDOP) {
+        return 0;
+    }
+    return 1;
+}
+
+/*
+ * reset the streaming parser, must be called before the first byte
+ */
+void init_NMEA_Parser(struct NMEA_Parser* p) {
+    memset(p, 0, sizeof(*p));
+    p->state = NMEA_WAIT_START;
+}
+
+/*
+ * feed one received byte to the parser
+ * return 1 and fill *out when the byte completed an RMC or ZDA sentence
+ * and the merged fix has time, date and a usable position
+ * => single pass: no sentence buffer, no strtok, no second checksum pass
+ */
+int parse_NMEA_char(struct NMEA_Parser* p, char c, struct TimePos* out) {
+    int digit;
+
+    p->stats.bytes++;
+
+    //a '$' always starts a new sentence, even in the middle of a broken one
+    if (c == '$') {
+        p->state = NMEA_FIELDS;
+        p->checksum = 0;
+        p->field = 0;
+        p->len = 0;
+        p->seen = 0;
+        p->sentence = 0;
+        memset(p->date, 0, sizeof(p->date));
+        return 0;
+    }
+
+    switch (p->state) {
+        case NMEA_FIELDS:
+            if (c == ',' || c == '*') {
+                p->field_buf[p->len] = '\0';
+                if (p->field == 0) {
+                    if (!decode_address(p)) {
+                        p->state = NMEA_WAIT_START;
+                        return 0;
+                    }
+                } else if (p->len != 0) {
+                    //empty fields (no fix yet) are simply not marked as seen
+                    if (!sentence_table[p->sentence - 1].decode(p)) {
+                        p->state = NMEA_WAIT_START;
+                        return 0;
+                    }
+                }
+                p->field++;
+                p->len = 0;
+                if (c == '*') {
+                    p->state = NMEA_CHECK_HI;
+                    return 0;
+                }
+            } else if (c < ' ' || c > '~' || p->len >= NMEA_FIELD_LEN) {
+                //line noise or a field too long to be ours
+                p->state = NMEA_WAIT_START;
+                return 0;
+            } else {
+                p->field_buf[p->len++] = c;
+            }
+            p->checksum ^= (unsigned char)c;
+            break;
+        case NMEA_CHECK_HI:
+            digit = hex_value(c);
+            if (digit < 0) {
+                p->state = NMEA_WAIT_START;
+                return 0;
+            }
+            p->rx_checksum = (unsigned char)(digit << 4);
+            p->state = NMEA_CHECK_LO;
+            break;
+        case NMEA_CHECK_LO:
+            p->state = NMEA_WAIT_START;
+            digit = hex_value(c);
+            if (digit < 0) {
+                return 0;
+            }
+            p->rx_checksum |= (unsigned char)digit;
+            if (p->rx_checksum != p->checksum) {
+                return 0;
+            }
+            //intact sentence => its fields replace the ones in the fix
+            merge_fix(p);
+            if (p->sentence == NMEA_RMC) {
+                p->stats.rmc++;
+            } else if (p->sentence == NMEA_GGA) {
+                p->stats.gga++;
+                //no date => time and date would disagree across midnight
+                return 0;
+            } else {
+                p->stats.zda++;
+            }
+            if ((p->fix.valid & (FIX_TIME | FIX_DATE)) != (FIX_TIME | FIX_DATE)
+                    || !NMEA_fix_usable(&p->fix)) {
+                return 0;
+            }
+            out->time = p->fix.time;
+            out->second = p->fix.second;
+            out->ordinal_date = p->fix.ordinal_date;
+            out->year = p->fix.year;
+            out->latitude = p->fix.latitude;
+            out->longitude = p->fix.longitude;
+            p->stats.fixes++;
+            return 1;
+        default:
+            //NMEA_WAIT_START: skip everything up to the next '$'
+            break;
+    }
+
+    return 0;
+}
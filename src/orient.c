@@ -0,0 +1,194 @@
+/**
+ * @file    orient.c
+ * @author  Mustafa Siddiqui
+ * @brief   Function definitions for the fused orientation.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "../inc/orient.h"
+#include "../inc/accel.h"   // ACCEL_getFiltered(), ACCEL_Zenith()
+#include "../inc/mag.h"     // MAG_getFiltered(), MAG_Azimuth()
+#include "../inc/magcal.h"  // MAGCAL_correct()
+#include "../inc/fixmath.h" // FX_atan2(), FX_magnitude()
+//-//
+#include <xc.h>
+
+/* Timer1 ticks per ms => 250 kHz */
+#define TICKS_PER_MS    250UL
+
+/* alpha-beta state => written by ORIENT_ISR() at low priority */
+struct ORIENT_Track {
+    uint32_t angle;         // BAM << 16
+    int32_t rate;           // BAM << 16 per block
+};
+static struct ORIENT_Track zenith;
+static struct ORIENT_Track heading;
+static volatile uint32_t estimateTicks;
+static volatile uint16_t estimateSkew;
+static volatile unsigned char primed;
+static volatile unsigned char coast;    // blocks since the last correction
+
+/* last samples seen by ORIENT_ISR() */
+static struct SensorSample lastAccel;
+static struct SensorSample lastMag;
+
+/* zenith as a binary angle: elevation of y above the x,z plane */
+static int16_t ORIENT_zenith(const int16_t *accel) {
+    // = 90 deg - acos(y / |a|), as ACCEL_Zenith()
+    return FX_atan2(accel[1], FX_magnitude(accel[0], 0, accel[2]));
+}
+
+/* predict, then correct by the residual */
+static void ORIENT_track(struct ORIENT_Track *t, int16_t measured, unsigned char correct) {
+    t->angle += (uint32_t)t->rate;
+    if (!correct) {
+        // no measurement to check the rate against => let it die out
+        t->rate -= t->rate >> ORIENT_DECAY_SHIFT;
+        return;
+    }
+    // 32-bit difference of angles wraps to (-180, 180] deg
+    int32_t residual = (int32_t)(((uint32_t)(uint16_t)measured << 16) - t->angle);
+    t->angle += (uint32_t)(residual >> ORIENT_ALPHA_SHIFT);
+    t->rate += residual >> ORIENT_BETA_SHIFT;
+}
+
+/* heading of the x axis in the horizontal plane */
+int16_t ORIENT_heading(const int16_t *accel, const int16_t *mag) {
+    int32_t mx = ORIENT_MAG_X(mag);
+    int32_t my = ORIENT_MAG_Y(mag);
+    int32_t mz = ORIENT_MAG_Z(mag);
+
+    // up = a / |a| in Q14 => |u| <= 16384
+    int32_t len = FX_magnitude(accel[0], accel[1], accel[2]);
+    if (len == 0) {
+        return FX_atan2(my, mx);    // free fall or no data => as if level
+    }
+    int32_t ux = (int32_t)accel[0] * (1L << ORIENT_Q) / len;
+    int32_t uy = (int32_t)accel[1] * (1L << ORIENT_Q) / len;
+    int32_t uz = (int32_t)accel[2] * (1L << ORIENT_Q) / len;
+
+    // m . u in Q14 => |m| * 2^14 <= 2^30
+    int32_t mu = mx * ux + my * uy + mz * uz;
+    int32_t muCounts = (mu + (1L << (ORIENT_Q - 1))) >> ORIENT_Q;
+
+    // components of the horizontal field along x and along up x x, Q14
+    int32_t X = mx * (1L << ORIENT_Q) - muCounts * ux;
+    int32_t Y = my * uz - mz * uy;
+
+    return FX_atan2(Y, X);
+}
+
+/* start over */
+void initOrient(void) {
+    unsigned char giel = INTCONbits.GIEL;
+    INTCONbits.GIEL = 0;
+    primed = 0;
+    lastAccel.seq = 0;
+    lastMag.seq = 0;
+    INTCONbits.GIEL = giel;
+}
+
+/* new accelerometer block => one filter step */
+void ORIENT_ISR(void) {
+    MAG_getSample(&lastMag);
+    if (!ACCEL_getSample(&lastAccel) || lastMag.seq == 0) {
+        return;
+    }
+
+    int16_t mag[3] = {lastMag.axis[0], lastMag.axis[1], lastMag.axis[2]};
+    MAGCAL_correct(mag);
+    int16_t z = ORIENT_zenith(lastAccel.axis);
+    int16_t h = ORIENT_heading(lastAccel.axis, mag);
+
+    int32_t diff = (int32_t)(lastAccel.ticks - lastMag.ticks);
+    uint32_t skew = (diff < 0) ? -(uint32_t)diff : (uint32_t)diff;
+    if (skew > ORIENT_MAX_SKEW_MS * TICKS_PER_MS) {
+        return;     // magnetometer has stalled
+    }
+
+    if (!primed) {
+        coast = 0;
+        zenith.angle = (uint32_t)(uint16_t)z << 16;
+        heading.angle = (uint32_t)(uint16_t)h << 16;
+        zenith.rate = 0;
+        heading.rate = 0;
+        primed = 1;
+    } else {
+        // off 1 g => the block is not just gravity, so the tilt and the
+        // heading (which is projected with it) are both suspect
+        uint16_t g = FX_magnitude(lastAccel.axis[0], lastAccel.axis[1], lastAccel.axis[2]);
+        unsigned char still = (g >= ORIENT_G_MIN && g <= ORIENT_G_MAX);
+        if (still) {
+            coast = 0;
+        } else if (coast < ORIENT_MAX_COAST) {
+            coast++;
+        }
+
+        // too long without a correction => hold the angle, the rate is
+        // no longer known (ORIENT_getEstimate() reports no estimate)
+        if (coast < ORIENT_MAX_COAST) {
+            ORIENT_track(&zenith, z, still);
+            ORIENT_track(&heading, h, still);
+        } else {
+            zenith.rate = 0;
+            heading.rate = 0;
+        }
+    }
+    estimateTicks = lastAccel.ticks;
+    estimateSkew = (uint16_t)(skew / TICKS_PER_MS);
+}
+
+/* latest estimate */
+int ORIENT_getEstimate(struct ORIENT_Angles *angles) {
+    unsigned char giel = INTCONbits.GIEL;
+    INTCONbits.GIEL = 0;
+    unsigned char ok = primed && coast < ORIENT_MAX_COAST;
+    int16_t z = (int16_t)(zenith.angle >> 16);
+    int16_t h = (int16_t)(heading.angle >> 16);
+    angles->ticks = estimateTicks;
+    angles->skewMs = estimateSkew;
+    INTCONbits.GIEL = giel;
+
+    if (!ok) {
+        return 0;
+    }
+    angles->zenith = FX_BAM_TO_DEG(z);
+    angles->heading = h;
+    angles->azimuth = MAG_Azimuth(h);
+    return 1;
+}
+
+/* zenith and azimuth from one pair of samples */
+int ORIENT_getAngles(struct ORIENT_Angles *angles) {
+    struct SensorSample accel;
+    struct SensorSample mag;
+
+    // one pair => neither ISR runs between the two copies
+    unsigned char giel = INTCONbits.GIEL;
+    INTCONbits.GIEL = 0;
+    int ok = ACCEL_getFiltered(&accel) & MAG_getFiltered(&mag);
+    INTCONbits.GIEL = giel;
+    if (!ok) {
+        return 0;
+    }
+
+    // signed difference => right across the Timer1 count wrap
+    int32_t diff = (int32_t)(accel.ticks - mag.ticks);
+    uint32_t skew = (diff < 0) ? -(uint32_t)diff : (uint32_t)diff;
+    if (skew > ORIENT_MAX_SKEW_MS * TICKS_PER_MS) {
+        return 0;
+    }
+
+    // soft iron => the hard iron is already removed by the sensor
+    MAGCAL_correct(mag.axis);
+
+    angles->heading = ORIENT_heading(accel.axis, mag.axis);
+    angles->zenith = ACCEL_Zenith(accel.axis);
+    angles->azimuth = MAG_Azimuth(angles->heading);
+    angles->ticks = (diff > 0) ? accel.ticks : mag.ticks;
+    angles->skewMs = (uint16_t)(skew / TICKS_PER_MS);
+    return 1;
+}
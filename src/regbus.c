@@ -0,0 +1,89 @@
+/**
+ * @file    regbus.c
+ * @author  Mustafa Siddiqui
+ * @brief   Function definitions for register access to the SPI sensors.
+ * @date    10/16/2026
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../inc/regbus.h"
+#include "../inc/spi.h"     // _SPI_*() functions
+//-//
+#include <xc.h>
+
+/* [R/W, MB, address] */
+unsigned char REGBUS_command(const struct REGBUS_Device *dev, unsigned char addr, unsigned char dir, unsigned char len) {
+    unsigned char cmd = addr & dev->addrMask;
+    if (dir == REGBUS_READ) {
+        cmd |= dev->readBit;
+    }
+    if (len > 1) {
+        cmd |= dev->multiBit;
+    }
+    return cmd;
+}
+
+/* command and data bytes of one access => slave already selected */
+static signed char REGBUS_transfer(const struct REGBUS_Device *dev, const struct REGBUS_Op *op) {
+    signed char status = _SPI_write(REGBUS_command(dev, op->addr, op->dir, op->len));
+
+    // O(len)
+    for (unsigned char i = 0; i < op->len; i++) {
+        if (op->dir == REGBUS_READ) {
+            op->data[i] = _SPI_read();
+        } else if (_SPI_write(op->data[i]) != 0) {
+            status = -1;
+        }
+    }
+    return status;
+}
+
+/* write one register */
+signed char REGBUS_write(const struct REGBUS_Device *dev, unsigned char addr, unsigned char data) {
+    struct REGBUS_Op op = {addr, REGBUS_WRITE, &data, 1};
+
+    _SPI_selectSlave(dev->slave);
+    signed char status = REGBUS_transfer(dev, &op);
+    _SPI_unselectSlave(dev->slave);
+    return status;
+}
+
+/* read one register */
+unsigned char REGBUS_read(const struct REGBUS_Device *dev, unsigned char addr) {
+    unsigned char data = 0x00;
+    REGBUS_readBlock(dev, addr, &data, 1);
+    return data;
+}
+
+/* read consecutive registers in one ~CS window */
+void REGBUS_readBlock(const struct REGBUS_Device *dev, unsigned char addr, uint8_t *data, unsigned char len) {
+    struct REGBUS_Op op = {addr, REGBUS_READ, data, len};
+
+    _SPI_selectSlave(dev->slave);
+    REGBUS_transfer(dev, &op);
+    _SPI_unselectSlave(dev->slave);
+}
+
+/* several accesses, the bus taken once */
+signed char REGBUS_batch(const struct REGBUS_Device *dev, const struct REGBUS_Op *ops, unsigned char n) {
+    signed char status = 0;
+    if (n == 0) {
+        return 0;
+    }
+
+    // O(n + total len)
+    _SPI_selectSlave(dev->slave);
+    for (unsigned char i = 0; i < n; i++) {
+        if (i > 0) {
+            // ~CS high ends the command, low starts the next one
+            _SPI_reselectSlave(dev->slave);
+        }
+        if (REGBUS_transfer(dev, &ops[i]) != 0) {
+            status = -1;
+        }
+    }
+    _SPI_unselectSlave(dev->slave);
+    return status;
+}
@@ -0,0 +1,233 @@
+/**
+ * @file    rtc.c
+ * @author  Mustafa Siddiqui
+ * @brief   Function definitions for the Timer1 software real-time clock.
+ * @date    10/16/2026
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../inc/rtc.h"
+//-//
+#include <xc.h>
+
+#define SECONDS_PER_DAY 86400UL
+
+/* Timer1 raw tick counter wraps after 2^32 / 250 kHz = 4.7 hours */
+#define MAX_DRIFT_WINDOW_S  (4UL * 3600UL)
+
+/* clock state => written by the ISR, read with TMR1IE masked */
+static volatile uint16_t overflows;         // Timer1 bits 16-31
+static volatile uint32_t fracTicks;         // ticks into the current second
+static volatile uint32_t secondOfDay;
+static volatile uint32_t uptime;
+static volatile int ordinalDate;
+static volatile unsigned char year;         // years since 2000
+
+/* Timer1 ticks counted as one second => trimmed by RTC_sync() */
+static volatile uint32_t ticksPerSecond = RTC_NOMINAL_TPS;
+
+/* sync bookkeeping */
+static unsigned char valid;
+static float latitude;
+static float longitude;
+static uint32_t syncUptime;                 // uptime at the last sync
+static uint32_t anchorTicks;                // start of drift measurement
+static uint32_t anchorGpsSeconds;
+static uint32_t anchorUptime;
+static unsigned char anchorValid;
+static int32_t driftPpm;
+
+/* days in the current year (2000-2099 => every 4th year is a leap year) */
+static int RTC_daysInYear(unsigned char yy) {
+    return (yy % 4 == 0) ? 366 : 365;
+}
+
+/* GPS time as seconds since 01/01/2000 => used for intervals only */
+static uint32_t RTC_gpsSeconds(const struct TimePos *time_pos) {
+    uint32_t days = 365UL * time_pos->year + (time_pos->year + 3) / 4 + time_pos->ordinal_date;
+    return days * SECONDS_PER_DAY + time_pos->time * 60UL + time_pos->second;
+}
+
+/* start timer 1 */
+void initRTC(void) {
+    // bit7 = 1: RD16 => 16-bit reads, reading TMR1L latches TMR1H
+    // bit5:4 = 11: 1:8 prescaler => 250 kHz from Fosc/4
+    // bit3 = 0: Timer1 oscillator off, bit1 = 0: clock source Fosc/4
+    // bit0 = 1: timer on
+    T1CON = 0xB1;
+    TMR1H = 0;
+    TMR1L = 0;
+
+    valid = 0;
+    anchorValid = 0;
+    PIR1bits.TMR1IF = 0;
+    PIE1bits.TMR1IE = 1;
+}
+
+/* advance the clock by one second */
+static void RTC_tick(void) {
+    uptime++;
+    if (++secondOfDay < SECONDS_PER_DAY) {
+        return;
+    }
+
+    secondOfDay = 0;
+    if (++ordinalDate > RTC_daysInYear(year)) {
+        ordinalDate = 1;
+        year++;
+    }
+}
+
+/* timer 1 overflowed => 65536 more ticks */
+void RTC_ISR(void) {
+    if (PIE1bits.TMR1IE && PIR1bits.TMR1IF) {
+        PIR1bits.TMR1IF = 0;
+        overflows++;
+
+        // carry the remainder so no fraction of a second is ever lost
+        fracTicks += 65536UL;
+        while (fracTicks >= ticksPerSecond) {
+            fracTicks -= ticksPerSecond;
+            RTC_tick();
+        }
+    }
+}
+
+/* 32-bit timer 1 tick count */
+uint32_t RTC_getTicks(void) {
+    unsigned char ie = PIE1bits.TMR1IE;
+    PIE1bits.TMR1IE = 0;
+
+    uint16_t low = TMR1L;
+    low |= (uint16_t)TMR1H << 8;
+    uint16_t high = overflows;
+
+    // overflowed after masking but before TMR1 was read
+    if (PIR1bits.TMR1IF && low < 0x8000) {
+        high++;
+    }
+
+    PIE1bits.TMR1IE = ie;
+    return ((uint32_t)high << 16) | low;
+}
+
+/* set clock from GPS and measure the timer 1 rate */
+void RTC_sync(const struct TimePos *time_pos) {
+    uint32_t now = RTC_getTicks();
+    uint32_t up = RTC_getUptime();
+    uint32_t gpsSeconds = RTC_gpsSeconds(time_pos);
+
+    // estimate timer 1 rate against GPS time since the anchor
+    if (anchorValid) {
+        uint32_t gpsElapsed = gpsSeconds - anchorGpsSeconds;
+        uint32_t localElapsed = up - anchorUptime;
+
+        if (localElapsed > MAX_DRIFT_WINDOW_S || gpsElapsed > MAX_DRIFT_WINDOW_S) {
+            // raw tick counter wrapped => start a new measurement
+            anchorTicks = now;
+            anchorGpsSeconds = gpsSeconds;
+            anchorUptime = up;
+        } else if (gpsElapsed >= RTC_MIN_DRIFT_S) {
+            uint32_t ticks = now - anchorTicks;
+            int32_t excess = (int32_t)(ticks - gpsElapsed * RTC_NOMINAL_TPS);
+
+            // 1e6 / RTC_NOMINAL_TPS = 4
+            driftPpm = excess * 4 / (int32_t)gpsElapsed;
+
+            uint32_t tps = (ticks + gpsElapsed / 2) / gpsElapsed;
+            if (tps > RTC_NOMINAL_TPS + RTC_MAX_TRIM_TPS) {
+                tps = RTC_NOMINAL_TPS + RTC_MAX_TRIM_TPS;
+            } else if (tps < RTC_NOMINAL_TPS - RTC_MAX_TRIM_TPS) {
+                tps = RTC_NOMINAL_TPS - RTC_MAX_TRIM_TPS;
+            }
+
+            unsigned char ie = PIE1bits.TMR1IE;
+            PIE1bits.TMR1IE = 0;
+            ticksPerSecond = tps;
+            PIE1bits.TMR1IE = ie;
+
+            anchorTicks = now;
+            anchorGpsSeconds = gpsSeconds;
+            anchorUptime = up;
+        }
+    } else {
+        anchorTicks = now;
+        anchorGpsSeconds = gpsSeconds;
+        anchorUptime = up;
+        anchorValid = 1;
+    }
+
+    // set the time => second boundary is taken as now
+    unsigned char ie = PIE1bits.TMR1IE;
+    PIE1bits.TMR1IE = 0;
+    secondOfDay = time_pos->time * 60UL + time_pos->second;
+    ordinalDate = time_pos->ordinal_date;
+    year = time_pos->year;
+    fracTicks = 0;
+    PIE1bits.TMR1IE = ie;
+
+    latitude = time_pos->latitude;
+    longitude = time_pos->longitude;
+    syncUptime = up;
+    valid = 1;
+}
+
+/* rate measured elsewhere => takes over from the sync estimate */
+void RTC_setTicksPerSecond(uint32_t tps) {
+    if (tps > RTC_NOMINAL_TPS + RTC_MAX_TRIM_TPS || tps < RTC_NOMINAL_TPS - RTC_MAX_TRIM_TPS) {
+        return;
+    }
+    
+    unsigned char ie = PIE1bits.TMR1IE;
+    PIE1bits.TMR1IE = 0;
+    ticksPerSecond = tps;
+    PIE1bits.TMR1IE = ie;
+    
+    // 1e6 / RTC_NOMINAL_TPS = 4
+    driftPpm = ((int32_t)tps - (int32_t)RTC_NOMINAL_TPS) * 4;
+    anchorValid = 0;
+}
+
+/* clock has been set */
+int RTC_isValid(void) {
+    return valid;
+}
+
+/* current time and position of last fix */
+void RTC_getTimePos(struct TimePos *time_pos) {
+    unsigned char ie = PIE1bits.TMR1IE;
+    PIE1bits.TMR1IE = 0;
+    uint32_t sod = secondOfDay;
+    time_pos->ordinal_date = ordinalDate;
+    time_pos->year = year;
+    PIE1bits.TMR1IE = ie;
+
+    time_pos->time = (int)(sod / 60);
+    time_pos->second = (unsigned char)(sod % 60);
+    time_pos->latitude = latitude;
+    time_pos->longitude = longitude;
+}
+
+/* oscillator error measured at last sync */
+int32_t RTC_getDriftPpm(void) {
+    return driftPpm;
+}
+
+/* seconds since last sync */
+uint32_t RTC_getSecondsSinceSync(void) {
+    if (!valid) {
+        return 0xFFFFFFFFUL;
+    }
+    return RTC_getUptime() - syncUptime;
+}
+
+/* seconds since power up */
+uint32_t RTC_getUptime(void) {
+    unsigned char ie = PIE1bits.TMR1IE;
+    PIE1bits.TMR1IE = 0;
+    uint32_t seconds = uptime;
+    PIE1bits.TMR1IE = ie;
+    return seconds;
+}
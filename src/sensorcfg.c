@@ -0,0 +1,101 @@
+/**
+ * @file    sensorcfg.c
+ * @author  Mustafa Siddiqui
+ * @brief   Function definitions for the sensor configuration layer.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "../inc/sensorcfg.h"
+#include "../inc/eeprom.h"
+#include "../inc/accel.h"   // _ACCEL_writeToRegister(), _ADDR_*
+#include "../inc/mag.h"     // MAG_Write(), OFFSET_*_REG, CFG_REG_*
+//-//
+#include <stddef.h> // offsetof()
+
+/* bytes of the profile covered by the checksum */
+#define SENSORCFG_DATA      offsetof(struct SENSORCFG_Profile, accelOffset)
+#define SENSORCFG_DATA_LEN  (sizeof(struct SENSORCFG_Profile) - SENSORCFG_DATA)
+
+static struct SENSORCFG_Profile profile;
+
+/* checksum over everything but magic and checksum */
+static unsigned char SENSORCFG_checksum(const struct SENSORCFG_Profile *p) {
+    return EEPROM_checksum((const unsigned char *)p + SENSORCFG_DATA, SENSORCFG_DATA_LEN);
+}
+
+/* the values the firmware used to apply itself */
+static void SENSORCFG_setDefaults(void) {
+    profile.accelOffset[0] = SENSORCFG_ACCEL_OFSX;
+    profile.accelOffset[1] = SENSORCFG_ACCEL_OFSY;
+    profile.accelOffset[2] = SENSORCFG_ACCEL_OFSZ;
+    profile.accelBwRate = SENSORCFG_ACCEL_BW_RATE;
+    profile.magOffset[0] = SENSORCFG_MAG_OFFSET_X;
+    profile.magOffset[1] = SENSORCFG_MAG_OFFSET_Y;
+    profile.magOffset[2] = SENSORCFG_MAG_OFFSET_Z;
+    profile.magCfgA = SENSORCFG_MAG_CFG_A;
+    profile.magCfgB = SENSORCFG_MAG_CFG_B;
+    profile.magic = SENSORCFG_MAGIC;
+    profile.checksum = SENSORCFG_checksum(&profile);
+}
+
+/* load the stored profile */
+int initSensorConfig(void) {
+    EEPROM_readBlock(EE_ADDR_SENSORCFG, &profile, sizeof(profile));
+    if (profile.magic == SENSORCFG_MAGIC && profile.checksum == SENSORCFG_checksum(&profile)) {
+        return 1;
+    }
+
+    // blank or corrupt => not written back, defaults may change with the firmware
+    SENSORCFG_setDefaults();
+    return 0;
+}
+
+/* ADXL343 offsets and data rate */
+signed char SENSORCFG_applyAccel(void) {
+    signed char status = 0;
+
+    status |= _ACCEL_writeToRegister(_ADDR_OFSX, (unsigned char)profile.accelOffset[0]);
+    status |= _ACCEL_writeToRegister(_ADDR_OFSY, (unsigned char)profile.accelOffset[1]);
+    status |= _ACCEL_writeToRegister(_ADDR_OFSZ, (unsigned char)profile.accelOffset[2]);
+    status |= _ACCEL_writeToRegister(_ADDR_BW_RATE, profile.accelBwRate);
+
+    return status ? -1 : 0;
+}
+
+/* LIS2MDL hard-iron offsets, filter and data rate */
+signed char SENSORCFG_applyMag(void) {
+    signed char status = 0;
+
+    // OFFSET_X_REG_L..OFFSET_Z_REG_H are consecutive, low byte first
+    for (unsigned char c = 0; c < 3; c++) {
+        uint16_t offset = (uint16_t)profile.magOffset[c];
+        status |= MAG_Write(OFFSET_X_REG_L + 2 * c, (unsigned char)(offset & 0xFF));
+        status |= MAG_Write(OFFSET_X_REG_H + 2 * c, (unsigned char)(offset >> 8));
+    }
+    status |= MAG_Write(CFG_REG_B, profile.magCfgB);
+    status |= MAG_Write(CFG_REG_A, profile.magCfgA);
+
+    return status ? -1 : 0;
+}
+
+/* profile in use */
+void SENSORCFG_getProfile(struct SENSORCFG_Profile *out) {
+    *out = profile;
+}
+
+/* store and apply a new profile */
+signed char SENSORCFG_setProfile(const struct SENSORCFG_Profile *in) {
+    profile = *in;
+    profile.magic = SENSORCFG_MAGIC;
+    profile.checksum = SENSORCFG_checksum(&profile);
+
+    // only the changed cells are written
+    EEPROM_writeBlock(EE_ADDR_SENSORCFG, &profile, sizeof(profile));
+
+    signed char status = SENSORCFG_applyAccel();
+    status |= SENSORCFG_applyMag();
+    return status ? -1 : 0;
+}
@@ -11,6 +11,50 @@
 #include "../inc/spi.h"
 //-//
 #include <xc.h>
+#include <string.h> // memset(), memcpy()
+
+/* GIEL before the current transaction => see _SPI_selectSlave() */
+static unsigned char savedGIEL;
+
+/* SPI clock => per slave, and the one SSPCON1 is set to */
+static unsigned char slaveSpeed[SPI_NUM_SLAVES];
+static unsigned char activeSpeed;
+
+/* transfer counters => only touched while a slave is selected */
+static struct SPI_Stats stats[SPI_NUM_SLAVES];
+static unsigned char txBytes;
+static uint16_t startTicks;
+
+/* transaction queue => ring of SPI_QUEUE_LEN, run at low priority */
+static struct SPI_Transaction *queue[SPI_QUEUE_LEN];
+static unsigned char head;
+static volatile unsigned char queued;
+static volatile unsigned char active;   // queue[head] is on the bus
+static unsigned char owned;             // a blocking transaction has the bus
+static unsigned char pos;               // byte of queue[head] in SSPBUF
+
+/* low 16 bits of Timer1 => enough for one transaction */
+static uint16_t _SPI_timer(void) {
+    // reading TMR1L latches TMR1H (RD16)
+    uint16_t t = TMR1L;
+    t |= (uint16_t)TMR1H << 8;
+    return t;
+}
+
+/* switch the master clock => only with every ~CS high */
+static void _SPI_setClock(unsigned char speed) {
+    if (speed == activeSpeed) {
+        return;
+    }
+    
+    // SSPM is only written with the port off, where SCK falls back to
+    // the latch => hold it at the idle level (CKP = 1)
+    LATCbits.LATC3 = 1;
+    SSPCON1bits.SSPEN = 0;
+    SSPCON1 = (SSPCON1 & 0xF0) | speed;
+    SSPCON1bits.SSPEN = 1;
+    activeSpeed = speed;
+}
 
 /* enable serial port function */
 void _SPI_enableIO(void) {
@@ -67,15 +111,40 @@ void initSPI(void) {
     SSPCON1bits.SSPM0 = 0;
     
     // Note: at this stage, SSPCON1 = 0x32;
+    // => every slave starts here, SPI_tune() raises it
+    activeSpeed = SPI_FOSC_64;
+    for (int i = 0; i < SPI_NUM_SLAVES; i++) {
+        slaveSpeed[i] = SPI_FOSC_64;
+    }
+    memset(stats, 0, sizeof(stats));
+    for (int i = 0; i < SPI_NUM_SLAVES; i++) {
+        stats[i].speed = SPI_FOSC_64;
+    }
     
     // when data (8 bits) is received, SSPSTATbits.BF (buffer full bit) &
     // PIR1bits.SSPIF (interrupt flag bit) are set
     // => we will use SSPIF to detect when transfer is complete
     PIR1bits.SSPIF = 0;
+    
+    // queued transactions => SSPIF at low priority, enabled only while
+    // one is on the bus (blocking transfers poll the same flag)
+    head = 0;
+    queued = 0;
+    active = 0;
+    owned = 0;
+    PIE1bits.SSPIE = 0;
+    IPR1bits.SSPIP = 0;
 }
 
-/* select slave device at start of transmission */
-void _SPI_selectSlave(int slave) {
+/* clock, counters, then ~CS low => every ~CS is high on entry */
+static void _SPI_begin(int slave) {
+    // the slave's clock, then start counting
+    if (slave >= 1 && slave <= SPI_NUM_SLAVES) {
+        _SPI_setClock(slaveSpeed[slave - 1]);
+    }
+    txBytes = 0;
+    startTicks = _SPI_timer();
+
     // Chip Select pin (~CS) needs to pulled *low* in order to select it
     switch (slave) {
         case ACCELEROMETER:
@@ -94,8 +163,8 @@ void _SPI_selectSlave(int slave) {
     }
 }
 
-/* unselect slave device at end of transmission */
-void _SPI_unselectSlave(int slave) {
+/* ~CS high, then add the transaction to the counters */
+static void _SPI_end(int slave) {
     // pull ~CS pin high
     switch (slave) {
         case ACCELEROMETER:
@@ -108,6 +177,108 @@ void _SPI_unselectSlave(int slave) {
             // leave CS pins unchanged if incorrect slave
             break;
     }
+
+    if (slave >= 1 && slave <= SPI_NUM_SLAVES) {
+        struct SPI_Stats *s = &stats[slave - 1];
+        s->bytes += txBytes;
+        s->busyTicks += (uint16_t)(_SPI_timer() - startTicks);
+        s->transactions++;
+    }
+}
+
+/* start the transaction at the head of the queue, if the bus is free */
+static void _SPI_start(void) {
+    if (active) {
+        return;
+    }
+    if (owned || queued == 0) {
+        PIE1bits.SSPIE = 0;
+        return;
+    }
+    
+    struct SPI_Transaction *t = queue[head];
+    _SPI_begin(t->slave);
+    pos = 0;
+    active = 1;
+    
+    // first byte out, the rest from SPI_ISR() / _SPI_drain()
+    unsigned char tempVar;
+    tempVar = SSPBUF;               // clears BF
+    PIR1bits.SSPIF = 0;
+    SSPBUF = (t->txLen > 0) ? t->tx[0] : 0x00;
+    txBytes++;
+    PIE1bits.SSPIE = 1;
+}
+
+/* byte in SSPBUF done => store it, send the next or finish */
+static void _SPI_step(void) {
+    struct SPI_Transaction *t = queue[head];
+    unsigned char in = SSPBUF;      // clears BF
+    PIR1bits.SSPIF = 0;
+    
+    if (pos >= t->txLen) {
+        t->rx[pos - t->txLen] = in;
+    }
+    pos++;
+    
+    if (pos < t->txLen + t->rxLen) {
+        SSPBUF = (pos < t->txLen) ? t->tx[pos] : 0x00;
+        txBytes++;
+        return;
+    }
+    
+    // last byte => release the slave and hand over the result
+    _SPI_end(t->slave);
+    head = (head + 1) % SPI_QUEUE_LEN;
+    queued--;
+    active = 0;
+    t->done = 1;
+    if (t->complete) {
+        t->complete(t);
+    }
+    _SPI_start();
+}
+
+/* finish the transaction in flight by polling => GIEL already 0 */
+static void _SPI_drain(void) {
+    while (active) {
+        while (!PIR1bits.SSPIF);
+        _SPI_step();
+    }
+}
+
+/* select slave device at start of transmission */
+void _SPI_selectSlave(int slave) {
+    // the sensor data-ready handlers run SPI transactions at low
+    // priority => keep them from cutting into this one
+    // (inside those handlers GIEL is already 0, so this is a no-op)
+    savedGIEL = INTCONbits.GIEL;
+    INTCONbits.GIEL = 0;
+
+    // a queued transaction may be on the bus => let it finish, and
+    // hold the rest of the queue until _SPI_unselectSlave()
+    owned = 1;
+    _SPI_drain();
+    
+    _SPI_begin(slave);
+}
+
+/* unselect slave device at end of transmission */
+void _SPI_unselectSlave(int slave) {
+    _SPI_end(slave);
+    
+    // bus free => carry on with the queue
+    owned = 0;
+    _SPI_start();
+
+    INTCONbits.GIEL = savedGIEL;
+}
+
+/* new command on the selected slave => ~CS high, then low again */
+void _SPI_reselectSlave(int slave) {
+    // counted as two transactions, the bus stays taken
+    _SPI_end(slave);
+    _SPI_begin(slave);
 }
 
 /* write byte to slave device */
@@ -117,6 +288,7 @@ signed char _SPI_write(unsigned char data_out) {
     PIR1bits.SSPIF = 0;             // clear interrupt flag
     SSPCON1bits.WCOL = 0;           // clear any previous write collision
     SSPBUF = data_out;              // write byte to SSPBUF register
+    txBytes++;
     
     if (SSPCON1 & 0x80)             // test if write collision occurred
         return -1;                  // if WCOL bit is set return negative #
@@ -132,7 +304,147 @@ unsigned char _SPI_read(void) {
   tempVar = SSPBUF;         // clear BF
   PIR1bits.SSPIF = 0;       // clear interrupt flag
   SSPBUF = 0x00;            // initiate bus cycle
+  txBytes++;
   while(!PIR1bits.SSPIF);   // wait until cycle complete
 
   return SSPBUF;            // return with byte read
 }
+
+/* fastest clock that reads the slave's ID back every time */
+signed char SPI_tune(int slave, unsigned char readCmd, unsigned char expected) {
+    if (slave < 1 || slave > SPI_NUM_SLAVES) {
+        return -1;
+    }
+    
+    // slowest first => O(3 * SPI_TUNE_READS) transactions
+    signed char kept = -1;
+    unsigned char passed = 0;
+    for (signed char speed = SPI_FOSC_64; speed >= SPI_FOSC_4; speed--) {
+        slaveSpeed[slave - 1] = (unsigned char)speed;
+        
+        unsigned char ok = 1;
+        for (int i = 0; i < SPI_TUNE_READS; i++) {
+            _SPI_selectSlave(slave);
+            _SPI_write(readCmd);
+            unsigned char id = _SPI_read();
+            _SPI_unselectSlave(slave);
+            if (id != expected) {
+                ok = 0;
+            }
+        }
+        
+        if (ok) {
+            passed |= (unsigned char)(1 << speed);
+            kept = speed;
+        }
+    }
+    
+    slaveSpeed[slave - 1] = (kept < 0) ? SPI_FOSC_64 : (unsigned char)kept;
+    
+    // counters start with the kept clock
+    SPI_resetStats(slave);
+    stats[slave - 1].speed = slaveSpeed[slave - 1];
+    stats[slave - 1].passed = passed;
+    return kept;
+}
+
+/* copy the transfer counters */
+void SPI_getStats(int slave, struct SPI_Stats *out) {
+    if (slave < 1 || slave > SPI_NUM_SLAVES) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    
+    // updated by transactions in the low priority ISR
+    unsigned char giel = INTCONbits.GIEL;
+    INTCONbits.GIEL = 0;
+    memcpy(out, &stats[slave - 1], sizeof(*out));
+    INTCONbits.GIEL = giel;
+}
+
+/* zero the byte, time and transaction counters */
+void SPI_resetStats(int slave) {
+    if (slave < 1 || slave > SPI_NUM_SLAVES) {
+        return;
+    }
+    
+    unsigned char giel = INTCONbits.GIEL;
+    INTCONbits.GIEL = 0;
+    stats[slave - 1].bytes = 0;
+    stats[slave - 1].busyTicks = 0;
+    stats[slave - 1].transactions = 0;
+    INTCONbits.GIEL = giel;
+}
+
+/* bytes per ms while selected */
+uint16_t SPI_getThroughput(int slave) {
+    struct SPI_Stats s;
+    SPI_getStats(slave, &s);
+    if (s.busyTicks == 0) {
+        return 0;
+    }
+    
+    // bytes * 250 overflows after ~17 MB => divide the time down first
+    uint32_t rate;
+    if (s.bytes < UINT32_MAX / SPI_TICKS_PER_MS) {
+        rate = s.bytes * SPI_TICKS_PER_MS / s.busyTicks;
+    } else {
+        uint32_t ms = s.busyTicks / SPI_TICKS_PER_MS;
+        rate = s.bytes / ms;
+    }
+    return (rate > 0xFFFF) ? 0xFFFF : (uint16_t)rate;
+}
+
+/* queue a transaction => runs as soon as the bus is free */
+signed char SPI_submit(struct SPI_Transaction *t) {
+    unsigned int len = t->txLen + t->rxLen;
+    if (t->slave < 1 || t->slave > SPI_NUM_SLAVES || len == 0 || len > 255) {
+        return -1;
+    }
+    
+    // the queue is run at low priority
+    unsigned char giel = INTCONbits.GIEL;
+    INTCONbits.GIEL = 0;
+    if (queued >= SPI_QUEUE_LEN) {
+        INTCONbits.GIEL = giel;
+        return -1;
+    }
+    t->done = 0;
+    queue[(head + queued) % SPI_QUEUE_LEN] = t;
+    queued++;
+    _SPI_start();
+    INTCONbits.GIEL = giel;
+    return 0;
+}
+
+/* wait for every queued transaction */
+void SPI_flush(void) {
+    unsigned char giel = INTCONbits.GIEL;
+    INTCONbits.GIEL = 0;
+    // with a slave selected the queue is held => nothing to wait for
+    while (queued && !owned) {
+        _SPI_drain();
+        _SPI_start();
+    }
+    INTCONbits.GIEL = giel;
+}
+
+/* byte done on a queued transaction */
+void SPI_ISR(void) {
+    if (!(PIE1bits.SSPIE && PIR1bits.SSPIF)) {
+        return;
+    }
+    if (!active) {
+        PIE1bits.SSPIE = 0;
+        return;
+    }
+    
+    // at Fosc/4 a byte takes 16 Tcy, less than leaving and re-entering
+    // the ISR => poll to the end of the queue instead
+    do {
+        _SPI_step();
+        if (activeSpeed == SPI_FOSC_4) {
+            while (active && !PIR1bits.SSPIF);
+        }
+    } while (active && PIR1bits.SSPIF);
+}
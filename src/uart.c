@@ -7,18 +7,104 @@
 
 #include "../inc/uart.h"
 
+#define RX_MASK (UART_RX_SIZE - 1)
+#define TX_MASK (UART_TX_SIZE - 1)
+
+/*
+ * Ring buffers. Head and tail are free running counters so
+ * (head - tail) is always the fill level. Each index has exactly one
+ * writer (ISR or main code) and 8-bit accesses are atomic on the PIC18,
+ * so no interrupt masking is needed around the TX indices.
+ * => the RX ring holds 256 bytes, so its indices are 16-bit and main
+ *    code touches them with RCIE masked <=
+ */
+static volatile char rx_buf[UART_RX_SIZE];
+static volatile unsigned int rx_head;      // written by ISR
+static volatile unsigned int rx_tail;      // written by reader
+static volatile char tx_buf[UART_TX_SIZE];
+static volatile unsigned char tx_head;     // written by sender
+static volatile unsigned char tx_tail;     // written by ISR
+
+static volatile struct UART_Stats stats;
+static unsigned long baud_rate;
+
 /*
- * Interrupt that handles an incoming UART character
+ * Move bytes between the hardware and the ring buffers
+ */
+void UART_ISR(void) {
+    unsigned int level;
+
+    if (PIE1bits.RCIE && PIR1bits.RCIF) {
+        if (RCSTAbits.OERR) {
+            // receiver stops until CREN is toggled
+            stats.rx_overruns++;
+            CREN = 0;
+            NOP();
+            CREN = 1;
+        }
+        // drain the 2-deep hardware FIFO, RCIF clears when it is empty
+        while (PIR1bits.RCIF) {
+            char c = RCREG;
+            level = rx_head - rx_tail;
+            if (level < UART_RX_SIZE) {
+                rx_buf[rx_head & RX_MASK] = c;
+                rx_head++;
+                if (level + 1 > stats.rx_high_water) {
+                    stats.rx_high_water = level + 1;
+                }
+            } else {
+                stats.rx_dropped++;
+            }
+        }
+    }
+
+    if (PIE1bits.TXIE && PIR1bits.TXIF) {
+        if (tx_head != tx_tail) {
+            TXREG = tx_buf[tx_tail & TX_MASK];
+            tx_tail++;
+        } else {
+            // nothing left to send, TXIF stays set while TXREG is empty
+            PIE1bits.TXIE = 0;
+        }
+    }
+}
+
+/*
+ * Wait for the next byte in the RX ring and return it
  */
 char UART_Read_char() {
-    while(RCIF == 0); // see if data on RC7 pin is available 
-    if(RCSTAbits.OERR) { 
-        CREN = 0;
-        NOP();
-        CREN = 1;
+    char c;
+    while (!UART_try_read_char(&c)); // wait for the ISR to receive a byte
+    return c;
+}
+
+/*
+ * Return 1 and the next received byte, 0 if none is waiting
+ */
+int UART_try_read_char(char *c) {
+    int got = 0;
+
+    // 16-bit indices => the ISR must not see one half updated
+    unsigned char ie = PIE1bits.RCIE;
+    PIE1bits.RCIE = 0;
+    if (rx_head != rx_tail) {
+        *c = rx_buf[rx_tail & RX_MASK];
+        rx_tail++;
+        got = 1;
     }
-    
-    return(RCREG); //read the byte from receive register and return value
+    PIE1bits.RCIE = ie;
+    return got;
+}
+
+/*
+ * Bytes waiting in the RX ring
+ */
+unsigned int UART_rx_count(void) {
+    unsigned char ie = PIE1bits.RCIE;
+    PIE1bits.RCIE = 0;
+    unsigned int count = rx_head - rx_tail;
+    PIE1bits.RCIE = ie;
+    return count;
 }
 
 /*
@@ -28,24 +114,86 @@ void UART_RX_Init(void) {
     // Set the RX-TX pins to be in UART mode, not I/O
     TRISCbits.RC7 = 1;
     TRISCbits.RC6 = 0;
-    
-    SPBRG = 51; // 9600bps @ 8MHz, 8bit baud rate generator, high speed
-    
+
+    rx_head = rx_tail = 0;
+    tx_head = tx_tail = 0;
+
+    UART_set_baud(UART_DEFAULT_BAUD); // 16bit baud rate generator, high speed
+
     RCSTAbits.CREN = 1; // Asyncronous mode continuous receiver
     RCSTAbits.SPEN = 1; // Serial port enabled
-    BAUDCONbits.BRG16 = 0; // 8bit baud rate generator
-    
+
     TXSTAbits.SYNC = 0; // Asyncronous mode
-    TXSTAbits.BRGH = 1; // High speed
-    TXSTAbits.TXEN = 1; // Transmit enable 
+    TXSTAbits.TXEN = 1; // Transmit enable
+
+    memset((void *)&stats, 0, sizeof(stats));
+
+    // RX interrupt is always on, TX interrupt only while the ring has data
+    // => global/peripheral enables are set in initInterrupts()
+    PIE1bits.TXIE = 0;
+    PIE1bits.RCIE = 1;
+}
+
+/*
+ * Everything queued has been sent
+ */
+int UART_tx_idle(void) {
+    return (tx_head == tx_tail) && TXSTAbits.TRMT;
+}
+
+/*
+ * Set baud rate with the 16-bit generator: baud = Fosc / (4 * (n + 1))
+ */
+void UART_set_baud(unsigned long baud) {
+    unsigned int n = (unsigned int)((_XTAL_FREQ / 4 + baud / 2) / baud) - 1;
+
+    // let bytes already queued go out at the old rate
+    while (!UART_tx_idle());
+
+    unsigned char cren = RCSTAbits.CREN;
+    RCSTAbits.CREN = 0; // don't receive garbage while switching
+    BAUDCONbits.BRG16 = 1;
+    TXSTAbits.BRGH = 1;
+    SPBRGH = (unsigned char)(n >> 8);
+    SPBRG = (unsigned char)(n & 0xFF);
+    RCSTAbits.CREN = cren;
+
+    baud_rate = baud;
+}
+
+/*
+ * Current baud rate
+ */
+unsigned long UART_get_baud(void) {
+    return baud_rate;
+}
+
+/*
+ * Queue a single character, return 0 if the TX ring is full
+ */
+int UART_try_send_char(char c) {
+    unsigned char level = (unsigned char)(tx_head - tx_tail);
+
+    if (level >= UART_TX_SIZE) {
+        stats.tx_dropped++;
+        return 0;
+    }
+    tx_buf[tx_head & TX_MASK] = c;
+    tx_head++;
+    if (level + 1 > stats.tx_high_water) {
+        stats.tx_high_water = level + 1;
+    }
+    PIE1bits.TXIE = 1;  // ISR sends it as soon as TXREG is free
+    return 1;
 }
 
 /*
  * Send a single character over UART
+ * => only waits if the TX ring is full
  */
 void UART_send_char(char c) {
-    while(!PIR1bits.TXIF); // Wait until TXREG is empty
-    TXREG = c;
+    while ((unsigned char)(tx_head - tx_tail) >= UART_TX_SIZE); // wait for room
+    UART_try_send_char(c);
 }
 
 /*
@@ -56,3 +204,26 @@ void UART_send_str(const char *str) {
         UART_send_char(character);
     }
 }
+
+/*
+ * Queue as much of a string as fits, return number of chars queued
+ */
+int UART_try_send_str(const char *str) {
+    int count = 0;
+    while (str[count] != '\0' && UART_try_send_char(str[count])) {
+        count++;
+    }
+    return count;
+}
+
+/*
+ * Copy the driver counters
+ */
+void UART_get_stats(struct UART_Stats *out) {
+    // ISR may update the counters mid-copy, take a consistent snapshot
+    // => restore GIE as it was, callers may already have it off
+    unsigned char gie = INTCONbits.GIE;
+    INTCONbits.GIE = 0;
+    memcpy(out, (const void *)&stats, sizeof(stats));
+    INTCONbits.GIE = gie;
+}
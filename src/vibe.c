@@ -0,0 +1,157 @@
+/**
+ * @file    vibe.c
+ * @author  Mustafa Siddiqui
+ * @brief   Function definitions for the vibration monitor.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "../inc/vibe.h"
+#include "../inc/fixmath.h" // FX_isqrt()
+//-//
+#include <xc.h>
+#include <string.h> // memset(), memcpy()
+
+static const int16_t binCos[VIBE_NUM_BINS] = VIBE_BIN_COS;
+static const int16_t binSin[VIBE_NUM_BINS] = VIBE_BIN_SIN;
+
+/* block in progress => only touched by VIBE_push() */
+static int16_t dc[3];               // previous block mean, removed from samples
+static int32_t sum[3];
+static uint32_t sumSq[3];
+static int32_t s1[VIBE_NUM_BINS];   // Goertzel state
+static int32_t s2[VIBE_NUM_BINS];
+static unsigned char count;
+static unsigned char primed;        // dc holds a block mean
+static unsigned char trip;          // bad blocks in a row
+static uint16_t quiet;              // quiet blocks while windy
+
+/* last result => read under GIEL */
+static volatile struct VIBE_Stats stats;
+
+/* start over */
+void initVibe(void) {
+    unsigned char giel = INTCONbits.GIEL;
+    INTCONbits.GIEL = 0;
+    memset(sum, 0, sizeof(sum));
+    memset(sumSq, 0, sizeof(sumSq));
+    memset(s1, 0, sizeof(s1));
+    memset(s2, 0, sizeof(s2));
+    memset((void *)&stats, 0, sizeof(stats));
+    count = 0;
+    primed = 0;
+    trip = 0;
+    quiet = 0;
+    INTCONbits.GIEL = giel;
+}
+
+/* |re + j im| ~ max + 3/8 min => within 7%, no square root */
+static uint32_t VIBE_magnitude(int32_t re, int32_t im) {
+    uint32_t a = (re < 0) ? -(uint32_t)re : (uint32_t)re;
+    uint32_t b = (im < 0) ? -(uint32_t)im : (uint32_t)im;
+    return (a > b) ? a + ((3 * b) >> 3) : b + ((3 * a) >> 3);
+}
+
+/* analyse the finished block */
+static void VIBE_endBlock(void) {
+    uint32_t var = 0;
+
+    // per axis: variance around the block mean, then shift dc to it
+    for (unsigned char c = 0; c < 3; c++) {
+        int32_t mean = sum[c] / VIBE_N;
+        uint32_t meanSq = (uint32_t)(mean * mean);
+        uint32_t v = sumSq[c] / VIBE_N;
+        var += (v > meanSq) ? v - meanSq : 0;
+        dc[c] += (int16_t)mean;
+    }
+    stats.rms = FX_isqrt(var);
+
+    // Goertzel => X = s1 - s2 e^-jw, amplitude = 2 |X| / N
+    unsigned char dominant = 0;
+    for (unsigned char b = 0; b < VIBE_NUM_BINS; b++) {
+        int32_t re = s1[b] - ((s2[b] * binCos[b]) >> 12);
+        int32_t im = (s2[b] * binSin[b]) >> 12;
+        uint32_t amp = (2 * VIBE_magnitude(re, im)) / VIBE_N;
+        stats.amp[b] = (amp > 0xFFFF) ? 0xFFFF : (uint16_t)amp;
+        if (stats.amp[b] > stats.amp[dominant]) {
+            dominant = b;
+        }
+    }
+    stats.dominant = dominant;
+    stats.blocks++;
+
+    // the first block only centres the samples
+    if (!primed) {
+        primed = 1;
+        return;
+    }
+
+    // trip after VIBE_TRIP_BLOCKS, clear after VIBE_CLEAR_BLOCKS
+    if (stats.rms > VIBE_RMS_STOW || stats.amp[dominant] > VIBE_RES_STOW) {
+        quiet = 0;
+        if (trip < VIBE_TRIP_BLOCKS) {
+            trip++;
+        }
+        if (trip >= VIBE_TRIP_BLOCKS) {
+            stats.windy = 1;
+        }
+    } else {
+        trip = 0;
+        if (stats.windy && ++quiet >= VIBE_CLEAR_BLOCKS) {
+            stats.windy = 0;
+            quiet = 0;
+        }
+    }
+}
+
+/* one sample => O(3 + VIBE_NUM_BINS) */
+void VIBE_push(const int16_t *sample) {
+    int16_t dev[3];
+
+    for (unsigned char c = 0; c < 3; c++) {
+        int16_t x = sample[c] >> VIBE_SHIFT;
+        if (!primed && count == 0) {
+            dc[c] = x;  // centre the first block on its first sample
+        }
+        int16_t d = x - dc[c];
+        if (d > VIBE_CLAMP) {
+            d = VIBE_CLAMP;
+        } else if (d < -VIBE_CLAMP) {
+            d = -VIBE_CLAMP;
+        }
+        dev[c] = d;
+        sum[c] += d;
+        sumSq[c] += (uint32_t)((int32_t)d * d);
+    }
+
+    // s = x + 2 cos(w) s1 - s2, |s| < 64 * 256 / sin(w) < 2^18 => fits
+    for (unsigned char b = 0; b < VIBE_NUM_BINS; b++) {
+        int32_t s = dev[VIBE_AXIS] + ((2 * binCos[b] * s1[b]) >> 12) - s2[b];
+        s2[b] = s1[b];
+        s1[b] = s;
+    }
+
+    if (++count == VIBE_N) {
+        VIBE_endBlock();
+        memset(sum, 0, sizeof(sum));
+        memset(sumSq, 0, sizeof(sumSq));
+        memset(s1, 0, sizeof(s1));
+        memset(s2, 0, sizeof(s2));
+        count = 0;
+    }
+}
+
+/* stow requested */
+int VIBE_isWindy(void) {
+    return stats.windy;     // 8-bit => atomic
+}
+
+/* last block */
+void VIBE_getStats(struct VIBE_Stats *out) {
+    unsigned char giel = INTCONbits.GIEL;
+    INTCONbits.GIEL = 0;
+    memcpy(out, (const void *)&stats, sizeof(*out));
+    INTCONbits.GIEL = giel;
+}
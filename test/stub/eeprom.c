@@ -0,0 +1,58 @@
+/**
+ * @file    eeprom.c
+ * @author  Mustafa Siddiqui
+ * @brief   Host stand-in for the data EEPROM driver: the same functions
+ *          over a RAM array that starts erased (0xFF).
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "../../inc/eeprom.h"
+//-//
+#include <string.h> // memset(), memcpy()
+
+static unsigned char cells[EEPROM_SIZE];
+static unsigned char erased;
+
+static void EEPROM_erase(void) {
+    if (!erased) {
+        memset(cells, 0xFF, sizeof(cells));
+        erased = 1;
+    }
+}
+
+unsigned char EEPROM_readByte(unsigned int addr) {
+    EEPROM_erase();
+    return cells[addr % EEPROM_SIZE];
+}
+
+void EEPROM_writeByte(unsigned int addr, unsigned char data) {
+    EEPROM_erase();
+    cells[addr % EEPROM_SIZE] = data;
+}
+
+void EEPROM_readBlock(unsigned int addr, void *dst, unsigned int len) {
+    unsigned char *bytes = (unsigned char *)dst;
+    for (unsigned int i = 0; i < len; i++) {
+        bytes[i] = EEPROM_readByte(addr + i);
+    }
+}
+
+void EEPROM_writeBlock(unsigned int addr, const void *src, unsigned int len) {
+    const unsigned char *bytes = (const unsigned char *)src;
+    for (unsigned int i = 0; i < len; i++) {
+        EEPROM_writeByte(addr + i, bytes[i]);
+    }
+}
+
+/* same as the driver's, records checked on the host must match */
+unsigned char EEPROM_checksum(const void *data, unsigned int len) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    unsigned char sum = 0;
+    for (unsigned int i = 0; i < len; i++) {
+        sum += bytes[i];
+    }
+    return (unsigned char)~sum;
+}
@@ -0,0 +1,17 @@
+/**
+ * @file    pic18.h
+ * @author  Mustafa Siddiqui
+ * @brief   Host stand-in for the XC8 PIC18 header, everything needed
+ *          is in the stub xc.h.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _HOST_PIC18_H_
+#define _HOST_PIC18_H_
+
+#include <xc.h>
+
+#endif /* _HOST_PIC18_H_ */
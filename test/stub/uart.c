@@ -0,0 +1,87 @@
+/**
+ * @file    uart.c
+ * @author  Mustafa Siddiqui
+ * @brief   Host stand-in for the UART functions gps.c and gpscfg.c use.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "uart_stub.h"
+#include "../../inc/uart.h"
+//-//
+#include <stdio.h>  // fprintf()
+
+static const char *feed;
+static unsigned long feedLen;
+static unsigned long feedPos;
+static char sent[512];
+static unsigned int sentLen;
+static unsigned long baudRate = UART_DEFAULT_BAUD;
+static struct UART_Stats stats;
+
+/* queue received bytes */
+void UART_stub_feed(const char *data, unsigned long len) {
+    feed = data;
+    feedLen = len;
+    feedPos = 0;
+}
+
+/* bytes not read yet */
+unsigned long UART_stub_pending(void) {
+    return feedLen - feedPos;
+}
+
+/* next byte if there is one */
+int UART_try_read_char(char *c) {
+    if (feedPos >= feedLen) {
+        return 0;
+    }
+    *c = feed[feedPos++];
+    return 1;
+}
+
+/* next byte => running dry would hang the firmware, stop the test instead */
+char UART_Read_char(void) {
+    char c;
+    if (!UART_try_read_char(&c)) {
+        fprintf(stderr, "UART_Read_char(): feed exhausted\n");
+        exit(1);
+    }
+    return c;
+}
+
+/* count lost bytes */
+void UART_stub_lose(unsigned int count) {
+    stats.rx_dropped += count;
+}
+
+/* text sent so far => cleared on read */
+const char *UART_stub_sent(void) {
+    sent[sentLen] = '\0';
+    sentLen = 0;
+    return sent;
+}
+
+/* keep what fits */
+void UART_send_str(const char *str) {
+    while (*str != '\0' && sentLen < sizeof(sent) - 1) {
+        sent[sentLen++] = *str++;
+    }
+}
+
+/* nothing to program */
+void UART_set_baud(unsigned long baud) {
+    baudRate = baud;
+}
+
+/* rate last set */
+unsigned long UART_get_baud(void) {
+    return baudRate;
+}
+
+/* driver counters */
+void UART_get_stats(struct UART_Stats *out) {
+    *out = stats;
+}
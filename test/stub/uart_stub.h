@@ -0,0 +1,47 @@
+/**
+ * @file    uart_stub.h
+ * @author  Mustafa Siddiqui
+ * @brief   Host stand-in for the UART driver: the bytes handed to
+ *          UART_stub_feed() are what UART_Read_char() and
+ *          UART_try_read_char() return, in order. What is sent is
+ *          kept for UART_stub_sent(), the baud rate is only stored.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _UART_STUB_H_
+#define _UART_STUB_H_
+
+/**
+ * @brief   Queue received bytes, replacing whatever was left unread.
+ * @param   data: bytes to receive, not copied => must stay valid
+ * @param   len: number of bytes
+ * @return  NULL
+ */
+void UART_stub_feed(const char *data, unsigned long len);
+
+/**
+ * @brief   Bytes queued by UART_stub_feed() that were not read yet.
+ * @param   NULL
+ * @return  number of bytes
+ */
+unsigned long UART_stub_pending(void);
+
+/**
+ * @brief   Count received bytes as lost, as the driver does when the RX
+ *          ring is full => shows up in UART_get_stats().rx_dropped.
+ * @param   count: number of bytes
+ * @return  NULL
+ */
+void UART_stub_lose(unsigned int count);
+
+/**
+ * @brief   Everything sent since the last call, then start over.
+ * @param   NULL
+ * @return  null terminated text, valid until the next send
+ */
+const char *UART_stub_sent(void);
+
+#endif /* _UART_STUB_H_ */
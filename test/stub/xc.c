@@ -0,0 +1,14 @@
+/**
+ * @file    xc.c
+ * @author  Mustafa Siddiqui
+ * @brief   Register variables declared by the host stub xc.h.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include <xc.h>
+
+volatile struct HOST_INTCONbits INTCONbits;
+volatile struct HOST_PIE1bits PIE1bits;
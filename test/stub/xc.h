@@ -0,0 +1,38 @@
+/**
+ * @file    xc.h
+ * @author  Mustafa Siddiqui
+ * @brief   Host stand-in for the XC8 device header. Only the special
+ *          function register bits touched by the modules built on the
+ *          host (see CMakeLists.txt) are declared; they are plain
+ *          variables defined in xc.c.
+ *          => never on the include path of the firmware build <=
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _HOST_XC_H_
+#define _HOST_XC_H_
+
+struct HOST_INTCONbits {
+    unsigned GIE : 1;
+    unsigned GIEL : 1;
+    unsigned PEIE : 1;
+};
+
+struct HOST_PIE1bits {
+    unsigned TMR1IE : 1;
+    unsigned RCIE : 1;
+    unsigned TXIE : 1;
+};
+
+extern volatile struct HOST_INTCONbits INTCONbits;
+extern volatile struct HOST_PIE1bits PIE1bits;
+
+#define NOP()   ((void)0)
+
+/* busy waits => no time passes on the host */
+#define __delay_ms(ms)  ((void)(ms))
+
+#endif /* _HOST_XC_H_ */
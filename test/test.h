@@ -0,0 +1,32 @@
+/**
+ * @file    test.h
+ * @author  Mustafa Siddiqui
+ * @brief   Minimal checks for the host tests: a failed CHECK() is
+ *          printed and counted, and TEST_END() makes it the exit code
+ *          ctest looks at.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef _TEST_H_
+#define _TEST_H_
+
+#include <stdio.h>  // printf()
+
+static int test_failures;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            test_failures++; \
+        } \
+    } while (0)
+
+#define TEST_END() do { \
+        printf("%s\n", test_failures ? "FAILED" : "ok"); \
+        return test_failures != 0; \
+    } while (0)
+
+#endif /* _TEST_H_ */
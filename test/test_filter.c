@@ -0,0 +1,174 @@
+/**
+ * @file    test_filter.c
+ * @author  Mustafa Siddiqui
+ * @brief   Host test of the streaming filters in filter.c against
+ *          brute-force references recomputed from the raw samples.
+ * @date    10/16/2026
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "test.h"
+#include "../inc/filter.h"
+//-//
+#include <stdlib.h> // abs()
+
+#define SAMPLES     100000L
+
+/* deterministic pseudo random int16 */
+static uint32_t seed = 12345;
+static int16_t rand16(void) {
+    seed = seed * 1103515245UL + 12345UL;
+    return (int16_t)(seed >> 16);
+}
+
+/* mean of the last n samples, rounded half away from zero */
+static int16_t ref_mean(const int16_t *x, long n) {
+    int64_t sum = 0;
+    for (long i = 0; i < n; i++) {
+        sum += x[i];
+    }
+    int64_t half = n / 2;
+    return (int16_t)((sum < 0 ? sum - half : sum + half) / n);
+}
+
+/* sum((x - mean)^2) / n about the rounded mean, saturated */
+static uint32_t ref_variance(const int16_t *x, long n) {
+    int16_t mean = ref_mean(x, n);
+    uint64_t sum = 0;
+    for (long i = 0; i < n; i++) {
+        int64_t d = (int64_t)x[i] - mean;
+        sum += (uint64_t)(d * d);
+    }
+    return (sum > UINT32_MAX) ? UINT32_MAX : (uint32_t)(sum / n);
+}
+
+/* every window length over random samples, including the fill-up */
+static void test_avg(void) {
+    static int16_t x[SAMPLES];
+    struct FILTER_Avg f;
+    long wrongMean = 0, wrongVar = 0;
+
+    for (long i = 0; i < SAMPLES; i++) {
+        x[i] = rand16();
+    }
+    for (unsigned char len = 1; len <= FILTER_MAX_WINDOW; len++) {
+        FILTER_avgInit(&f, len);
+        CHECK(FILTER_avgGet(&f) == 0 && FILTER_avgVariance(&f) == 0);
+        for (long i = 0; i < SAMPLES; i++) {
+            FILTER_avgPush(&f, x[i]);
+            long n = (i + 1 < len) ? i + 1 : len;
+            wrongMean += (FILTER_avgGet(&f) != ref_mean(&x[i + 1 - n], n));
+            wrongVar += (FILTER_avgVariance(&f) != ref_variance(&x[i + 1 - n], n));
+        }
+    }
+    CHECK(wrongMean == 0);
+    CHECK(wrongVar == 0);
+
+    //window length is clamped
+    FILTER_avgInit(&f, 0);
+    CHECK(f.len == 1);
+    FILTER_avgInit(&f, FILTER_MAX_WINDOW + 1);
+    CHECK(f.len == FILTER_MAX_WINDOW);
+
+    //full scale swings saturate the variance instead of wrapping
+    FILTER_avgInit(&f, FILTER_MAX_WINDOW);
+    for (int i = 0; i < FILTER_MAX_WINDOW; i++) {
+        FILTER_avgPush(&f, (i & 1) ? 32767 : -32768);
+    }
+    CHECK(FILTER_avgGet(&f) == -1);     // -0.5 rounds away from zero
+    CHECK(FILTER_avgVariance(&f) == UINT32_MAX);
+}
+
+/* median of what is in the window, by sorting it */
+static int16_t ref_median(const int16_t *x, int n) {
+    int16_t s[FILTER_MEDIAN_LEN];
+    for (int i = 0; i < n; i++) {
+        s[i] = x[i];
+    }
+    for (int i = 1; i < n; i++) {
+        for (int j = i; j > 0 && s[j - 1] > s[j]; j--) {
+            int16_t t = s[j];
+            s[j] = s[j - 1];
+            s[j - 1] = t;
+        }
+    }
+    return s[(n - 1) / 2];
+}
+
+static void test_median(void) {
+    static const int16_t v[3] = {-5, 0, 7};
+    struct FILTER_Median f;
+    int16_t x[FILTER_MEDIAN_LEN];
+    long wrong = 0;
+
+    //every order of three distinct values, and ties
+    for (int a = 0; a < 3; a++) {
+        for (int b = 0; b < 3; b++) {
+            for (int c = 0; c < 3; c++) {
+                int16_t w[3] = {v[a], v[b], v[c]};
+                wrong += (FILTER_median3(v[a], v[b], v[c]) != ref_median(w, 3));
+            }
+        }
+    }
+    CHECK(wrong == 0);
+
+    FILTER_medianInit(&f);
+    for (long i = 0; i < SAMPLES; i++) {
+        x[i % FILTER_MEDIAN_LEN] = rand16();
+        int n = (i + 1 < FILTER_MEDIAN_LEN) ? (int)i + 1 : FILTER_MEDIAN_LEN;
+        wrong += (FILTER_medianPush(&f, x[i % FILTER_MEDIAN_LEN]) != ref_median(x, n));
+    }
+    CHECK(wrong == 0);
+
+    //a single spike never gets through
+    FILTER_medianInit(&f);
+    FILTER_medianPush(&f, 100);
+    FILTER_medianPush(&f, 100);
+    CHECK(FILTER_medianPush(&f, 30000) == 100);
+    CHECK(FILTER_medianPush(&f, 101) == 101);
+}
+
+static void test_ema(void) {
+    struct FILTER_Ema f;
+
+    //first sample is taken as is
+    FILTER_emaInit(&f, 4);
+    CHECK(FILTER_emaGet(&f) == 0);
+    FILTER_emaPush(&f, -1234);
+    CHECK(FILTER_emaGet(&f) == -1234);
+
+    //a constant input is reached, from either side, for every shift
+    for (unsigned char shift = 1; shift <= 15; shift++) {
+        FILTER_emaInit(&f, shift);
+        FILTER_emaPush(&f, -30000);
+        for (long i = 0; i < 40L << shift && i < 2000000L; i++) {
+            FILTER_emaPush(&f, 20000);
+        }
+        CHECK(abs(FILTER_emaGet(&f) - 20000) <= 1);
+        for (long i = 0; i < 40L << shift && i < 2000000L; i++) {
+            FILTER_emaPush(&f, -20000);
+        }
+        CHECK(abs(FILTER_emaGet(&f) + 20000) <= 1);
+    }
+
+    //after 2^shift samples of a step, about 1 - 1/e of the way there
+    FILTER_emaInit(&f, 4);
+    FILTER_emaPush(&f, 0);
+    for (int i = 0; i < 16; i++) {
+        FILTER_emaPush(&f, 1000);
+    }
+    CHECK(FILTER_emaGet(&f) > 600 && FILTER_emaGet(&f) < 680);
+
+    //shift is clamped
+    FILTER_emaInit(&f, 20);
+    CHECK(f.shift == 15);
+}
+
+int main(void) {
+    test_avg();
+    test_median();
+    test_ema();
+    TEST_END();
+}
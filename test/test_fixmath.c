@@ -0,0 +1,157 @@
+/**
+ * @file    test_fixmath.c
+ * @author  Mustafa Siddiqui
+ * @brief   Host test of the fixed-point kernels in fixmath.c against
+ *          double precision libm, checked against the error bounds
+ *          quoted in fixmath.h.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "test.h"
+#include "../inc/fixmath.h"
+//-//
+#include <math.h>   // sin(), atan2(), sqrt(), acos()
+
+#define DEG_PER_BAM (360.0 / 65536)
+#define RAD_PER_BAM (M_PI / 32768)
+
+/* bounds from fixmath.h */
+#define MAX_SIN_LSB     4.0
+#define MAX_ATAN2_DEG   0.02
+#define MAX_ACOS_DEG    0.02
+#define MAX_MAG_LSB     0.5
+
+/* deterministic pseudo random int16 */
+static uint32_t seed = 12345;
+static int16_t rand16(void) {
+    seed = seed * 1103515245UL + 12345UL;
+    return (int16_t)(seed >> 16);
+}
+
+/* |a - b| in degrees with b in degrees and a a binary angle, wrapped */
+static double bam_err(int16_t a, double deg) {
+    double d = fmod(a * DEG_PER_BAM - deg + 540.0, 360.0) - 180.0;
+    return fabs(d);
+}
+
+/* every binary angle */
+static void test_sin_cos(void) {
+    double maxSin = 0, maxCos = 0;
+
+    for (uint32_t a = 0; a < 65536; a++) {
+        double s = FX_sin((uint16_t)a) - 32767.0 * sin(a * RAD_PER_BAM);
+        double c = FX_cos((uint16_t)a) - 32767.0 * cos(a * RAD_PER_BAM);
+        maxSin = fmax(maxSin, fabs(s));
+        maxCos = fmax(maxCos, fabs(c));
+    }
+    printf("FX_sin    max %.2f LSB, FX_cos max %.2f LSB\n", maxSin, maxCos);
+    CHECK(maxSin <= MAX_SIN_LSB);
+    CHECK(maxCos <= MAX_SIN_LSB);
+}
+
+static double atan2_err(int32_t y, int32_t x) {
+    return bam_err(FX_atan2(y, x), atan2((double)y, (double)x) * 180.0 / M_PI);
+}
+
+/* int16 grid over the full range, the axes and 32-bit inputs */
+static void test_atan2(void) {
+    double maxErr = 0;
+
+    for (int32_t y = -32768; y <= 32767; y += 61) {
+        for (int32_t x = -32768; x <= 32767; x += 61) {
+            if (x != 0 || y != 0) {
+                maxErr = fmax(maxErr, atan2_err(y, x));
+            }
+        }
+    }
+    for (int32_t v = -32768; v <= 32767; v++) {
+        if (v != 0) {
+            maxErr = fmax(maxErr, atan2_err(v, 32767));
+            maxErr = fmax(maxErr, atan2_err(32767, v));
+            maxErr = fmax(maxErr, atan2_err(v, -1));
+            maxErr = fmax(maxErr, atan2_err(1, v));
+        }
+    }
+    for (int i = 0; i < 1000000; i++) {
+        int32_t y = (int32_t)rand16() * 65536 + (uint16_t)rand16();
+        int32_t x = (int32_t)rand16() * 65536 + (uint16_t)rand16();
+        if (x != 0 || y != 0) {
+            maxErr = fmax(maxErr, atan2_err(y, x));
+        }
+    }
+    printf("FX_atan2  max %.4f deg\n", maxErr);
+    CHECK(maxErr <= MAX_ATAN2_DEG);
+
+    //documented range [-180, 180): the negative x axis is -180 deg
+    CHECK(FX_atan2(0, 0) == 0);
+    CHECK(FX_atan2(0, -100) == INT16_MIN);
+    CHECK(FX_atan2(100, 0) == FX_BAM_90);
+    CHECK(FX_atan2(-100, 0) == -FX_BAM_90);
+}
+
+/* floor(sqrt()) exactly, around every perfect square and at the ends */
+static void test_isqrt(void) {
+    int wrong = 0;
+
+    for (uint32_t n = 0; n < (1UL << 20); n++) {
+        uint32_t r = FX_isqrt(n);
+        wrong += !((uint64_t)r * r <= n && (uint64_t)(r + 1) * (r + 1) > n);
+    }
+    for (uint32_t k = 1; k < 65536; k++) {
+        uint32_t sq = k * k;
+        wrong += (FX_isqrt(sq) != k);
+        wrong += (FX_isqrt(sq - 1) != k - 1);
+    }
+    CHECK(wrong == 0);
+    CHECK(FX_isqrt(0xFFFFFFFFUL) == 65535);
+    printf("FX_isqrt  exact floor, %d wrong\n", wrong);
+}
+
+/* random triples plus the corners of the int16 cube */
+static void test_magnitude(void) {
+    static const int16_t corners[] = {INT16_MIN, -1, 0, 1, INT16_MAX};
+    double maxErr = 0;
+
+    for (int i = 0; i < 2000000; i++) {
+        int16_t x = rand16(), y = rand16(), z = rand16();
+        double ref = sqrt((double)x * x + (double)y * y + (double)z * z);
+        maxErr = fmax(maxErr, fabs(FX_magnitude(x, y, z) - ref));
+    }
+    for (int a = 0; a < 5; a++) {
+        for (int b = 0; b < 5; b++) {
+            for (int c = 0; c < 5; c++) {
+                int16_t x = corners[a], y = corners[b], z = corners[c];
+                double ref = sqrt((double)x * x + (double)y * y + (double)z * z);
+                maxErr = fmax(maxErr, fabs(FX_magnitude(x, y, z) - ref));
+            }
+        }
+    }
+    printf("FX_magnitude max %.3f LSB\n", maxErr);
+    CHECK(maxErr <= MAX_MAG_LSB);
+    CHECK(FX_magnitude(INT16_MIN, INT16_MIN, INT16_MIN) == 56756);
+}
+
+/* every Q15 input */
+static void test_acos(void) {
+    double maxErr = 0;
+
+    for (int32_t c = -32768; c <= 32767; c++) {
+        double cc = (c < -FX_ONE) ? -1.0 : c / 32767.0;
+        double ref = acos(cc) * 180.0 / M_PI;
+        maxErr = fmax(maxErr, fabs(FX_acos((int16_t)c) * DEG_PER_BAM - ref));
+    }
+    printf("FX_acos   max %.4f deg\n", maxErr);
+    CHECK(maxErr <= MAX_ACOS_DEG);
+}
+
+int main(void) {
+    test_sin_cos();
+    test_atan2();
+    test_isqrt();
+    test_magnitude();
+    test_acos();
+    TEST_END();
+}
@@ -0,0 +1,178 @@
+/**
+ * @file    test_gpscfg.c
+ * @author  Mustafa Siddiqui
+ * @brief   Host tests for the EM506 configure/verify sequence in
+ *          gpscfg.c, against a receiver model that obeys $PSRF103 and
+ *          $PSRF100 and sends one burst of sentences per second.
+ * @date    10/16/2026
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "test.h"
+#include "uart_stub.h"
+#include "../inc/gpscfg.h"
+#include "../inc/gps.h"     // poll_time_pos()
+#include "../inc/uart.h"    // UART_get_baud()
+//-//
+#include <string.h> // strstr()
+
+/* simulated RTC, one tick per burst */
+static uint32_t uptime;
+
+uint32_t RTC_getUptime(void) {
+    return uptime;
+}
+
+/* receiver model */
+static unsigned char rx_configured;     // $PSRF103 seen => RMC + GGA only
+static unsigned long rx_baud;           // rate it sends at
+
+/* "$" body "*XX\r\n" with the checksum of body, appended to buf */
+static size_t append(char* buf, size_t len, const char* body) {
+    unsigned char cs = 0;
+
+    for (const char* c = body; *c != '\0'; c++) {
+        cs ^= (unsigned char)*c;
+    }
+    return len + sprintf(buf + len, "$%s*%02X\r\n", body, cs);
+}
+
+/* act on the commands sent since the last burst */
+static void receiver_commands(void) {
+    const char* tx = UART_stub_sent();
+    const char* baud = strstr(tx, "$PSRF100,1,");
+
+    if (strstr(tx, "$PSRF103") != NULL) {
+        rx_configured = 1;
+    }
+    if (baud != NULL) {
+        rx_baud = strtoul(baud + 11, NULL, 10);
+    }
+}
+
+/*
+ * one second: the burst arrives, the main loop drains it and services
+ * the sequence => 'lose' bytes of the GGA never make it into the ring
+ */
+static void second(unsigned int lose) {
+    static char burst[1024];
+    char body[96];
+    struct TimePos tp;
+    size_t len = 0;
+    size_t cut;
+
+    unsigned int s = uptime % 60;
+    unsigned int m = uptime / 60;
+    sprintf(body, "GPGGA,17%02u%02u.000,4308.0842,N,07737.3612,W,1,08,0.9,167.2,M,-34.3,M,,", m, s);
+    len = append(burst, len, body);
+    cut = len;
+    if (!rx_configured) {
+        len = append(burst, len, "GPGSA,A,3,05,07,13,15,20,24,28,30,,,,,1.6,0.9,1.3");
+        len = append(burst, len, "GPGSV,3,1,10,05,45,123,42,07,30,060,38,13,70,300,45,15,12,200,33");
+        len = append(burst, len, "GPGSV,3,2,10,20,25,250,36,24,55,080,44,28,18,160,30,30,40,020,40");
+        len = append(burst, len, "GPGSV,3,3,10,02,05,330,,09,03,100,");
+    }
+    sprintf(body, "GPRMC,17%02u%02u.000,A,4308.0842,N,07737.3612,W,0.12,231.50,150426,,,A", m, s);
+    len = append(burst, len, body);
+
+    if (rx_baud == UART_get_baud()) {
+        if (lose > 0) {
+            // the tail of the GGA is gone, whatever follows arrives
+            memmove(burst + cut - lose, burst + cut, len - cut);
+            len -= lose;
+            UART_stub_lose(lose);
+        }
+        UART_stub_feed(burst, len);
+        while (poll_time_pos(&tp));
+    }
+
+    uptime++;
+    GPSCFG_service();
+    receiver_commands();
+}
+
+/* receiver at its defaults, sequence restarted */
+static void start(void) {
+    rx_configured = 0;
+    rx_baud = UART_DEFAULT_BAUD;
+    UART_set_baud(UART_DEFAULT_BAUD);
+    UART_stub_sent();
+    initGPSConfig();
+}
+
+/* nothing lost => configured, then moved to the first faster rate */
+static void test_clean(void) {
+    struct GPSCFG_Report report;
+
+    start();
+    for (int i = 0; i < 60; i++) {
+        second(0);
+    }
+    GPSCFG_getReport(&report);
+    CHECK(report.state == GPSCFG_CONFIGURED);
+    CHECK(report.baud == 57600 && UART_get_baud() == 57600);
+    CHECK(report.attempts == 1 && report.baud_attempts == 1);
+    CHECK(report.bytes_per_fix_after < report.bytes_per_fix_before);
+    CHECK(report.lost_windows == 0);
+}
+
+/* bursts lost to a busy main loop are no receiver reset */
+static void test_lost_bursts(void) {
+    struct GPSCFG_Report report;
+
+    start();
+    for (int i = 0; i < 60; i++) {
+        second(0);
+    }
+
+    // every burst lost whole => no sentences counted, like a silent link
+    unsigned long baud = rx_baud;
+    rx_baud = 0;
+    for (int i = 0; i < 25; i++) {
+        UART_stub_lose(150);
+        second(0);
+    }
+    rx_baud = baud;
+    GPSCFG_getReport(&report);
+    CHECK(report.state == GPSCFG_CONFIGURED);
+    CHECK(UART_get_baud() == 57600);
+    CHECK(report.lost_windows >= 2);
+
+    // a real reset => silent without losses, dropped back and redone
+    rx_configured = 0;
+    rx_baud = UART_DEFAULT_BAUD;
+    for (int i = 0; i < 12; i++) {
+        second(0);
+    }
+    CHECK(UART_get_baud() == UART_DEFAULT_BAUD);
+    for (int i = 0; i < 60; i++) {
+        second(0);
+    }
+    GPSCFG_getReport(&report);
+    CHECK(report.state == GPSCFG_CONFIGURED);
+    CHECK(UART_get_baud() == 57600);
+}
+
+/* losses at a raised rate fail it even though RMC gets through */
+static void test_lossy_rate(void) {
+    struct GPSCFG_Report report;
+
+    start();
+    for (int i = 0; i < 90; i++) {
+        second(UART_get_baud() == 57600 ? 20 : 0);
+    }
+    GPSCFG_getReport(&report);
+    CHECK(report.state == GPSCFG_CONFIGURED);
+    CHECK(report.baud == 38400 && UART_get_baud() == 38400);
+    CHECK(report.baud_attempts == 3);   // 57600, back to 9600, 38400
+    CHECK(report.lost_windows == 1);
+}
+
+int main(void) {
+    test_clean();
+    test_lost_bursts();
+    test_lossy_rate();
+    TEST_END();
+}
@@ -0,0 +1,204 @@
+/**
+ * @file    test_magcal.c
+ * @author  Mustafa Siddiqui
+ * @brief   Host test of the ellipse fit in magcal.c: random synthetic
+ *          hard/soft-iron distortions of a horizontal field are fitted
+ *          with MAGCAL_fit() and the heading the fitted correction gives
+ *          is compared with the true one; MAGCAL_correct() is checked
+ *          against the matrix it loads from EEPROM.
+ * @date    10/16/2026
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "test.h"
+#include "../inc/magcal.h"
+#include "../inc/eeprom.h"      // EEPROM_writeBlock(), EE_ADDR_MAGCAL
+#include "../inc/mag.h"         // MAG_getSample()
+#include "../inc/motor.h"       // moveMotor(), stopMotor()
+#include "../inc/sensorcfg.h"   // SENSORCFG_*Profile()
+//-//
+#include <math.h>   // sin(), cos(), atan2(), fmod()
+
+#define CASES           2000
+#define PI              3.14159265358979323846
+
+/* heading error of the fitted correction, degrees => the samples and */
+/* the centre are whole counts, 0.5 / 113 rad = 0.25 deg each */
+#define MAX_ERR_DEG     0.75    // exact field, rounded to counts
+#define MAX_ERR_NOISY   1.5     // +-2 counts on earth's 113 count field
+
+/* only MAGCAL_run() uses these => never called here */
+int MAG_getSample(struct SensorSample *sample) { (void)sample; return 0; }
+void moveMotor(int dutyCycle, int dir, int motorNum) { (void)dutyCycle; (void)dir; (void)motorNum; }
+void stopMotor(int motorNum) { (void)motorNum; }
+void SENSORCFG_getProfile(struct SENSORCFG_Profile *profile) { (void)profile; }
+signed char SENSORCFG_setProfile(const struct SENSORCFG_Profile *profile) { (void)profile; return 0; }
+
+/* deterministic pseudo random in [0, 1) */
+static uint32_t seed = 12345;
+static double rand01(void) {
+    seed = seed * 1103515245UL + 12345UL;
+    return (seed >> 8) / 16777216.0;
+}
+
+/* difference of two angles in degrees, wrapped into [0, 180] */
+static double angle_diff(double a, double b) {
+    double d = fmod(fabs(a - b), 360.0);
+    return (d > 180.0) ? 360.0 - d : d;
+}
+
+/* store the fitted matrix as MAGCAL_run() does, then load it back */
+static int load(const struct MAGCAL_Fit *fit) {
+    struct MAGCAL_Record record;
+
+    record.magic = MAGCAL_MAGIC;
+    for (int i = 0; i < 4; i++) {
+        record.softIron[i] = fit->softIron[i];
+    }
+    record.checksum = EEPROM_checksum(record.softIron, sizeof(record.softIron));
+    EEPROM_writeBlock(EE_ADDR_MAGCAL, &record, sizeof(record));
+    return initMagCal();
+}
+
+/*
+ * one sweep of 1.1 turns through a field of 'radius' counts distorted by
+ * a symmetric matrix (axes 1 and 1/ratio at angle phi) plus an offset
+ * => fit it and return the worst heading error of the fitted correction
+ *    over a full turn of exact field directions, -1 if the fit was refused
+ */
+static double sweep(double radius, double ratio, double phi, double cx, double cy, double noise) {
+    int16_t xy[MAGCAL_SAMPLES][2];
+    struct MAGCAL_Fit fit;
+    double c = cos(phi), s = sin(phi);
+    double start = 2 * PI * rand01();
+
+    // S = R(phi) diag(1, 1 / ratio) R(-phi)
+    double sxx = c * c + s * s / ratio;
+    double sxy = c * s * (1 - 1 / ratio);
+    double syy = s * s + c * c / ratio;
+
+    for (int i = 0; i < MAGCAL_SAMPLES; i++) {
+        double t = start + 1.1 * 2 * PI * i / MAGCAL_SAMPLES;
+        double fx = radius * cos(t);
+        double fy = radius * sin(t);
+        double x = cx + sxx * fx + sxy * fy + noise * (2 * rand01() - 1);
+        double y = cy + sxy * fx + syy * fy + noise * (2 * rand01() - 1);
+        xy[i][0] = (int16_t)lround(x);
+        xy[i][1] = (int16_t)lround(y);
+    }
+
+    if (!MAGCAL_fit((const int16_t (*)[2])xy, MAGCAL_SAMPLES, &fit)) {
+        return -1;
+    }
+
+    // a symmetric distortion keeps the direction of its axes => the
+    // corrected heading is the true one, no rotation to take out
+    double worst = 0;
+    for (int deg = 0; deg < 360; deg++) {
+        double t = deg * PI / 180;
+        double x = sxx * cos(t) + sxy * sin(t) + (cx - fit.center[0]) / radius;
+        double y = sxy * cos(t) + syy * sin(t) + (cy - fit.center[1]) / radius;
+        double mx = fit.softIron[0] * x + fit.softIron[1] * y;
+        double my = fit.softIron[2] * x + fit.softIron[3] * y;
+        double err = angle_diff(atan2(my, mx) * 180 / PI, deg);
+        if (err > worst) {
+            worst = err;
+        }
+    }
+    return worst;
+}
+
+/* the fixed point correction is the stored matrix to within a count */
+static void test_correct(void) {
+    struct MAGCAL_Fit fit;
+    long wrong = 0;
+
+    for (int i = 0; i < 4; i++) {
+        fit.softIron[i] = (int16_t)(2 * MAGCAL_ONE * rand01() - MAGCAL_ONE);
+    }
+    CHECK(load(&fit));
+    for (long i = 0; i < 100000L; i++) {
+        int16_t m[3];
+        for (int k = 0; k < 3; k++) {
+            m[k] = (int16_t)(4000 * rand01() - 2000);
+        }
+        double x = (double)fit.softIron[0] * m[0] / MAGCAL_ONE + (double)fit.softIron[1] * m[1] / MAGCAL_ONE;
+        double y = (double)fit.softIron[2] * m[0] / MAGCAL_ONE + (double)fit.softIron[3] * m[1] / MAGCAL_ONE;
+        int16_t z = m[2];
+        MAGCAL_correct(m);
+        wrong += (fabs(m[0] - x) > 1 || fabs(m[1] - y) > 1 || m[2] != z);
+    }
+    CHECK(wrong == 0);
+}
+
+/* centres up to +-600, radii up to 380, axis ratios up to 1.6, any rotation */
+static void test_random(double noise, double radiusMin, double radiusMax, double bound) {
+    double worst = 0;
+    int refused = 0;
+
+    for (int i = 0; i < CASES; i++) {
+        double radius = radiusMin + (radiusMax - radiusMin) * rand01();
+        double ratio = 1 + 0.6 * rand01();
+        double phi = PI * rand01();
+        double cx = 1200 * rand01() - 600;
+        double cy = 1200 * rand01() - 600;
+        double err = sweep(radius, ratio, phi, cx, cy, noise);
+        if (err < 0) {
+            refused++;
+        } else if (err > worst) {
+            worst = err;
+        }
+    }
+    printf("noise +-%.0f, radius %.0f-%.0f: worst %.2f deg, %d of %d refused\n",
+           noise, radiusMin, radiusMax, worst, refused, CASES);
+    CHECK(refused == 0);
+    CHECK(worst <= bound);
+}
+
+/* implausible sweeps keep the old calibration */
+static void test_refused(void) {
+    int16_t xy[MAGCAL_SAMPLES][2];
+    struct MAGCAL_Fit fit;
+
+    //too few samples
+    CHECK(!MAGCAL_fit((const int16_t (*)[2])xy, 4, &fit));
+
+    //axes more than 2:1 apart
+    CHECK(sweep(200, 2.5, 0.3, 10, -20, 0) < 0);
+
+    //too small to tell from noise
+    CHECK(sweep(30, 1.0, 0, 0, 0, 0) < 0);
+
+    //a line, not an ellipse
+    for (int i = 0; i < MAGCAL_SAMPLES; i++) {
+        xy[i][0] = (int16_t)(-200 + 6 * i);
+        xy[i][1] = (int16_t)(50 + 3 * i);
+    }
+    CHECK(!MAGCAL_fit((const int16_t (*)[2])xy, MAGCAL_SAMPLES, &fit));
+
+    //scattered more than MAGCAL_MAX_RESIDUAL % of the radius
+    CHECK(sweep(100, 1.2, 1.0, 0, 0, 40) < 0);
+}
+
+/* nothing stored => identity */
+static void test_identity(void) {
+    struct MAGCAL_Record record;
+    int16_t m[3] = {123, -456, 789};
+
+    record.magic = 0xFF;
+    EEPROM_writeBlock(EE_ADDR_MAGCAL, &record, sizeof(record));
+    CHECK(!initMagCal());
+    MAGCAL_correct(m);
+    CHECK(m[0] == 123 && m[1] == -456 && m[2] == 789);
+}
+
+int main(void) {
+    test_identity();
+    test_correct();
+    test_random(0, 113, 380, MAX_ERR_DEG);
+    test_random(2, 113, 113, MAX_ERR_NOISY);
+    test_refused();
+    TEST_END();
+}
@@ -0,0 +1,154 @@
+/**
+ * @file    test_nmea.c
+ * @author  Mustafa Siddiqui
+ * @brief   Host tests for the streaming NMEA parser in nmea.c.
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "test.h"
+#include "../inc/nmea.h"
+//-//
+#include <math.h>   // fabsf()
+#include <string.h> // strlen()
+
+/* "$" body "*XX\r\n" with the checksum of body */
+static const char* sentence(const char* body) {
+    static char buf[128];
+    unsigned char cs = 0;
+
+    for (const char* c = body; *c != '\0'; c++) {
+        cs ^= (unsigned char)*c;
+    }
+    snprintf(buf, sizeof(buf), "$%s*%02X\r\n", body, cs);
+    return buf;
+}
+
+/* feed a sentence, return 1 if it completed a fix */
+static int feed(struct NMEA_Parser* p, const char* body, struct TimePos* tp) {
+    const char* str = sentence(body);
+    int done = 0;
+
+    for (size_t i = 0; i < strlen(str); i++) {
+        done |= parse_NMEA_char(p, str[i], tp);
+    }
+    return done;
+}
+
+static int near(float a, float b) {
+    return fabsf(a - b) < 1e-5f;
+}
+
+static void test_rmc_fix(void) {
+    struct NMEA_Parser p;
+    struct TimePos tp;
+
+    init_NMEA_Parser(&p);
+    CHECK(feed(&p, "GPRMC,171204.000,A,4308.0842,N,07737.3612,W,0.12,231.50,150426,,,A", &tp));
+    CHECK(tp.time == 17*60 + 12 && tp.second == 4);
+    CHECK(tp.ordinal_date == 31 + 28 + 31 + 15 && tp.year == 26);
+    CHECK(near(tp.latitude, 43 + 8.0842f / 60));
+    CHECK(near(tp.longitude, -(77 + 37.3612f / 60)));
+
+    CHECK(feed(&p, "GNRMC,000000.000,A,3352.1280,S,15112.5520,E,0.00,0.00,010124,,,D", &tp));
+    CHECK(near(tp.latitude, -(33 + 52.128f / 60)));
+    CHECK(near(tp.longitude, 151 + 12.552f / 60));
+}
+
+/* an empty coordinate with its hemisphere present is no position */
+static void test_empty_coord(void) {
+    struct NMEA_Parser p;
+    struct TimePos tp;
+
+    init_NMEA_Parser(&p);
+    CHECK(feed(&p, "GPRMC,171204.000,A,4308.0842,N,07737.3612,W,0.12,231.50,150426,,,A", &tp));
+    CHECK(!feed(&p, "GPRMC,171205.000,A,,N,,W,0.12,231.50,150426,,,A", &tp));
+    CHECK(!(p.fix.valid & FIX_POS));
+    CHECK(!feed(&p, "GPRMC,171206.000,A,4308.0842,N,,W,0.12,231.50,150426,,,A", &tp));
+    CHECK(!(p.fix.valid & FIX_POS));
+
+    //a stale southern value must not be flipped back either
+    CHECK(feed(&p, "GPRMC,171207.000,A,3352.1280,S,15112.5520,E,0.00,0.00,150426,,,A", &tp));
+    CHECK(!feed(&p, "GPGGA,171208.000,,S,,E,1,08,1.1,153.2,M,-34.4,M,,0000", &tp));
+    CHECK(!(p.fix.valid & FIX_POS));
+    CHECK(!feed(&p, "GPRMC,171209.000,A,,S,,E,0.00,0.00,150426,,,A", &tp));
+}
+
+/* minutes must be 2 digits below 60, long fractions are cut short */
+static void test_minutes(void) {
+    struct NMEA_Parser p;
+    struct TimePos tp;
+
+    init_NMEA_Parser(&p);
+    CHECK(!feed(&p, "GPRMC,171204.000,A,4360.0000,N,07737.3612,W,0.12,231.50,150426,,,A", &tp));
+    CHECK(!feed(&p, "GPRMC,171204.000,A,4308.0842,N,07799.3612,W,0.12,231.50,150426,,,A", &tp));
+    CHECK(!feed(&p, "GPRMC,171204.000,A,43108.084,N,07737.3612,W,0.12,231.50,150426,,,A", &tp));
+    CHECK(!feed(&p, "GPRMC,171204.000,A,438.0842,N,07737.3612,W,0.12,231.50,150426,,,A", &tp));
+    CHECK(feed(&p, "GPRMC,171204.000,A,4359.9999,N,07737.3612,W,0.12,231.50,150426,,,A", &tp));
+    CHECK(near(tp.latitude, 43 + 59.9999f / 60));
+
+    //7 fraction digits, the 7th is dropped
+    CHECK(feed(&p, "GPRMC,171204.000,A,4308.0842129,N,07737.361299,W,0.12,231.50,150426,,,A", &tp));
+    CHECK(near(tp.latitude, 43 + 8.084212f / 60));
+    CHECK(near(tp.longitude, -(77 + 37.361299f / 60)));
+
+    //the string helpers take any length
+    CHECK(near(parse_GPRMC(sentence("GPRMC,171204.000,A,4308.0842,N,07737.3612,W,0.12,231.50,150426,,,A")).latitude,
+               43 + 8.0842f / 60));
+}
+
+/* out of range time, date or coordinates drop the whole sentence */
+static void test_ranges(void) {
+    struct NMEA_Parser p;
+    struct TimePos tp;
+
+    init_NMEA_Parser(&p);
+    CHECK(!feed(&p, "GPRMC,996099.000,A,4308.0842,N,07737.3612,W,0.12,231.50,150426,,,A", &tp));
+    CHECK(!feed(&p, "GPRMC,240000.000,A,4308.0842,N,07737.3612,W,0.12,231.50,150426,,,A", &tp));
+    CHECK(!feed(&p, "GPRMC,176004.000,A,4308.0842,N,07737.3612,W,0.12,231.50,150426,,,A", &tp));
+    CHECK(!feed(&p, "GPRMC,171260.000,A,4308.0842,N,07737.3612,W,0.12,231.50,150426,,,A", &tp));
+    CHECK(!feed(&p, "GPRMC,171204.000,A,4308.0842,N,07737.3612,W,0.12,231.50,310226,,,A", &tp));
+    CHECK(!feed(&p, "GPRMC,171204.000,A,4308.0842,N,07737.3612,W,0.12,231.50,290226,,,A", &tp));
+    CHECK(!feed(&p, "GPRMC,171204.000,A,4308.0842,N,07737.3612,W,0.12,231.50,310426,,,A", &tp));
+    CHECK(!feed(&p, "GPRMC,171204.000,A,9100.0000,N,07737.3612,W,0.12,231.50,150426,,,A", &tp));
+    CHECK(!feed(&p, "GPRMC,171204.000,A,4308.0842,N,18100.0000,W,0.12,231.50,150426,,,A", &tp));
+    CHECK(p.stats.rmc == 0);
+
+    CHECK(feed(&p, "GPRMC,235959.000,A,9000.0000,S,18000.0000,E,0.12,231.50,290224,,,A", &tp));
+    CHECK(tp.time == 23*60 + 59 && tp.second == 59);
+    CHECK(tp.ordinal_date == 31 + 29 && tp.year == 24);
+    CHECK(near(tp.latitude, -90) && near(tp.longitude, 180));
+    CHECK(feed(&p, "GPRMC,000000.000,A,4308.0842,N,07737.3612,W,0.12,231.50,311226,,,A", &tp));
+    CHECK(tp.ordinal_date == 365);
+}
+
+/* ZDA without day or month still carries the time of day */
+static void test_zda_no_date(void) {
+    struct NMEA_Parser p;
+    struct TimePos tp;
+
+    init_NMEA_Parser(&p);
+    CHECK(feed(&p, "GPRMC,171204.000,A,4308.0842,N,07737.3612,W,0.12,231.50,150426,,,A", &tp));
+    CHECK(!feed(&p, "GPZDA,171205.00,,04,2026,00,00", &tp));
+    CHECK(p.stats.zda == 1);
+    CHECK(p.fix.time == 17*60 + 12 && p.fix.second == 5);
+    CHECK((p.fix.valid & (FIX_TIME | FIX_DATE)) == FIX_TIME);
+    CHECK(!feed(&p, "GPZDA,171206.00,15,,2026,00,00", &tp));
+    CHECK(p.stats.zda == 2 && p.fix.second == 6);
+
+    CHECK(feed(&p, "GPZDA,171207.00,15,04,2026,00,00", &tp));
+    CHECK(tp.second == 7 && tp.ordinal_date == 31 + 28 + 31 + 15);
+    CHECK(!feed(&p, "GPZDA,171208.00,31,04,2026,00,00", &tp));
+    CHECK(p.stats.zda == 3);
+}
+
+int main(void) {
+    test_rmc_fix();
+    test_empty_coord();
+    test_minutes();
+    test_ranges();
+    test_zda_no_date();
+    TEST_END();
+}
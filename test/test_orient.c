@@ -0,0 +1,312 @@
+/**
+ * @file    test_orient.c
+ * @author  Mustafa Siddiqui
+ * @brief   Host tests of orient.c: the tilt-compensated heading over
+ *          random poses in random earth fields, rounded to sensor
+ *          counts, against the heading worked out in floating point
+ *          from the pose itself; and the alpha-beta tracking in
+ *          ORIENT_ISR() fed a noisy synthetic pose block by block.
+ * @date    10/16/2026
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "test.h"
+#include "../inc/orient.h"
+#include "../inc/accel.h"   // ACCEL_*()
+#include "../inc/mag.h"     // MAG_*()
+#include "../inc/magcal.h"  // MAGCAL_correct()
+#include "../inc/fixmath.h" // FX_atan2(), FX_BAM_TO_DEG360()
+#include "../inc/sample.h"  // SAMPLE_NEXT_SEQ()
+//-//
+#include <math.h>   // sin(), cos(), atan2(), fmod()
+#include <stdlib.h> // abs()
+
+#define CASES           200000L
+#define PI              3.14159265358979323846
+
+/* earth's field ~ 0.5 G = 333 counts at 1.5 mG/LSB */
+#define FIELD_COUNTS    333
+
+/* worst heading error, degrees => inputs are whole counts, the */
+/* horizontal field is down to 114 counts at 70 deg inclination */
+#define MAX_ERR_DEG     0.5
+
+/* tracking a steady 40 deg/s turn, degrees */
+#define MAX_TURN_ERR_DEG    2.0
+
+/* tracking => one accelerometer block every 50 ms (Timer1 at 250 kHz), */
+/* the magnetometer sample 10 ms older */
+#define BLOCK_TICKS     12500UL
+#define MAG_LAG_TICKS   2500UL
+
+/* sensor noise, +- counts */
+#define ACCEL_NOISE     60
+#define MAG_NOISE       6
+
+/* slots ORIENT_ISR() reads => filled by block() */
+static struct SensorSample accelSlot;
+static struct SensorSample magSlot;
+
+static int getSample(const struct SensorSample *slot, struct SensorSample *sample) {
+    if (slot->seq == 0 || slot->seq == sample->seq) {
+        return 0;
+    }
+    *sample = *slot;
+    return 1;
+}
+
+int ACCEL_getSample(struct SensorSample *sample) { return getSample(&accelSlot, sample); }
+int MAG_getSample(struct SensorSample *sample) { return getSample(&magSlot, sample); }
+
+/* only ORIENT_getAngles() uses these */
+int ACCEL_getFiltered(struct SensorSample *sample) { (void)sample; return 0; }
+int MAG_getFiltered(struct SensorSample *sample) { (void)sample; return 0; }
+int ACCEL_Zenith(const int16_t *sensorData) { (void)sensorData; return 0; }
+int MAG_Azimuth(int16_t angle) { return FX_BAM_TO_DEG360(angle); }
+void MAGCAL_correct(int16_t *sensorData) { (void)sensorData; }
+
+/* deterministic pseudo random in [0, 1) */
+static uint32_t seed = 12345;
+static double rand01(void) {
+    seed = seed * 1103515245UL + 12345UL;
+    return (seed >> 8) / 16777216.0;
+}
+
+/* difference of two angles in degrees, wrapped into [0, 180] */
+static double angle_diff(double a, double b) {
+    double d = fmod(fabs(a - b), 360.0);
+    return (d > 180.0) ? 360.0 - d : d;
+}
+
+/* uniform in [-amp, amp] */
+static double noise(double amp) {
+    return amp * (2 * rand01() - 1);
+}
+
+static double dot(const double *a, const double *b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+/*
+ * the board tilted by 'tilt' about its x axis, then by 'roll' about the
+ * y axis, in a field of inclination 'incl' whose horizontal part is at
+ * 'yaw' from world x towards world y (z up), gravity scaled by 'g'
+ * => readings in counts with noise up to +-aNoise, +-mNoise, and the heading of north from the horizontal
+ *    projection of the board's x axis towards up x x, degrees
+ */
+static double pose(double yaw, double tilt, double roll, double incl,
+                   double g, double aNoise, double mNoise, int16_t *accel, int16_t *mag) {
+    double ct = cos(tilt), st = sin(tilt);
+    double cr = cos(roll), sr = sin(roll);
+    // board axes in world coordinates => columns of Ry(roll) Rx(tilt)
+    double bx[3] = {cr, 0, -sr};
+    double by[3] = {sr * st, ct, cr * st};
+    double bz[3] = {sr * ct, -st, cr * ct};
+    double up[3] = {0, 0, 1};
+    double f[3] = {cos(incl) * cos(yaw), cos(incl) * sin(yaw), -sin(incl)};
+
+    accel[0] = (int16_t)lround(g * ORIENT_1G * dot(bx, up) + noise(aNoise));
+    accel[1] = (int16_t)lround(g * ORIENT_1G * dot(by, up) + noise(aNoise));
+    accel[2] = (int16_t)lround(g * ORIENT_1G * dot(bz, up) + noise(aNoise));
+    mag[0] = (int16_t)lround(FIELD_COUNTS * dot(bx, f) + noise(mNoise));
+    mag[1] = (int16_t)lround(FIELD_COUNTS * dot(by, f) + noise(mNoise));
+    mag[2] = (int16_t)lround(FIELD_COUNTS * dot(bz, f) + noise(mNoise));
+
+    // angle from x_h to f_h, positive towards up x x_h
+    double xh[3] = {bx[0], bx[1], 0};
+    double fh[3] = {f[0], f[1], 0};
+    double cross = xh[0] * fh[1] - xh[1] * fh[0];
+    return atan2(cross, dot(xh, fh)) * 180 / PI;
+}
+
+/* random yaw, tilt +-90 deg, inclination up to 70 deg */
+static void test_heading(void) {
+    double worst = 0, worstLevel = 0;
+    double worstRaw = 0;
+    int16_t accel[3], mag[3];
+
+    for (long i = 0; i < CASES; i++) {
+        double yaw = 2 * PI * rand01();
+        double tilt = PI * rand01() - PI / 2;
+        double incl = 70 * PI / 180 * rand01();
+
+        double truth = pose(yaw, tilt, 0, incl, 1, 0, 0, accel, mag);
+        double err = angle_diff(ORIENT_heading(accel, mag) * 360.0 / 65536, truth);
+        if (err > worst) {
+            worst = err;
+        }
+        err = angle_diff(FX_atan2(mag[1], mag[0]) * 360.0 / 65536, truth);
+        if (err > worstRaw) {
+            worstRaw = err;
+        }
+
+        // level => the same as atan2(my, mx)
+        truth = pose(yaw, 0, 0, incl, 1, 0, 0, accel, mag);
+        err = angle_diff(ORIENT_heading(accel, mag) * 360.0 / 65536, truth);
+        if (err > worstLevel) {
+            worstLevel = err;
+        }
+    }
+    printf("heading: worst %.2f deg (level %.2f), uncompensated %.1f deg\n",
+           worst, worstLevel, worstRaw);
+    CHECK(worst <= MAX_ERR_DEG);
+    CHECK(worstLevel <= MAX_ERR_DEG);
+    CHECK(worstRaw > 90);   // the test sees what compensation is for
+}
+
+/* x off the tilt axis too => still the heading of x projected */
+static void test_roll(void) {
+    double worst = 0;
+    int16_t accel[3], mag[3];
+
+    for (long i = 0; i < CASES / 4; i++) {
+        double yaw = 2 * PI * rand01();
+        double tilt = PI * rand01() - PI / 2;
+        double roll = (60 * rand01() - 30) * PI / 180;
+        double incl = 70 * PI / 180 * rand01();
+
+        double truth = pose(yaw, tilt, roll, incl, 1, 0, 0, accel, mag);
+        double err = angle_diff(ORIENT_heading(accel, mag) * 360.0 / 65536, truth);
+        if (err > worst) {
+            worst = err;
+        }
+    }
+    printf("rolled up to 30 deg: worst %.2f deg\n", worst);
+    CHECK(worst <= 2 * MAX_ERR_DEG);
+}
+
+/* no gravity => as if level */
+static void test_free_fall(void) {
+    int16_t accel[3] = {0, 0, 0};
+    int16_t mag[3] = {0, 200, -300};
+
+    CHECK(ORIENT_heading(accel, mag) == FX_atan2(200, 0));
+}
+
+/* tracking state */
+static uint32_t ticks;
+static double single;       // heading from the last block alone, degrees
+
+/*
+ * one accelerometer block and the magnetometer sample before it, at
+ * heading 'yawDeg' and zenith 'tiltDeg' in a 60 deg inclined field,
+ * through ORIENT_ISR() => return the true heading, degrees
+ */
+static double block(double yawDeg, double tiltDeg, double g) {
+    int16_t accel[3], mag[3];
+    double truth = pose(yawDeg * PI / 180, tiltDeg * PI / 180, 0, 60 * PI / 180,
+                        g, ACCEL_NOISE, MAG_NOISE, accel, mag);
+
+    ticks += BLOCK_TICKS;
+    for (int i = 0; i < 3; i++) {
+        accelSlot.axis[i] = accel[i];
+        magSlot.axis[i] = mag[i];
+    }
+    accelSlot.ticks = ticks;
+    magSlot.ticks = ticks - MAG_LAG_TICKS;
+    accelSlot.seq = SAMPLE_NEXT_SEQ(accelSlot.seq);
+    magSlot.seq = SAMPLE_NEXT_SEQ(magSlot.seq);
+    ORIENT_ISR();
+
+    single = ORIENT_heading(accel, mag) * 360.0 / 65536;
+    return truth;
+}
+
+/* error of the current estimate, degrees, -1 if there is none */
+static double estimate_error(double truth) {
+    struct ORIENT_Angles angles;
+
+    if (!ORIENT_getEstimate(&angles)) {
+        return -1;
+    }
+    return angle_diff(angles.heading * 360.0 / 65536, truth);
+}
+
+/*
+ * level, tilted up to 30 deg at 15 deg/s, at rest, then a 40 deg/s
+ * turn from 300 deg across 0/360 to 60 deg
+ */
+static void test_tracking(void) {
+    struct ORIENT_Angles angles;
+    double truth;
+
+    initOrient();
+    CHECK(!ORIENT_getEstimate(&angles));
+
+    for (int i = 0; i < 40; i++) {
+        block(300, 0, 1);
+    }
+    for (int i = 0; i <= 40; i++) {
+        block(300, 30.0 * i / 40, 1);
+    }
+    CHECK(ORIENT_getEstimate(&angles) && abs(angles.zenith - 30) <= 1);
+
+    // at rest => less noise than one block on its own
+    double worstSingle = 0, worstEstimate = 0;
+    for (int i = 0; i < 400; i++) {
+        truth = block(300, 30, 1);
+        double err = angle_diff(single, truth);
+        if (err > worstSingle) {
+            worstSingle = err;
+        }
+        err = estimate_error(truth);
+        CHECK(err >= 0);
+        if (err > worstEstimate) {
+            worstEstimate = err;
+        }
+    }
+    printf("at rest: worst %.2f deg, single block %.2f deg\n", worstEstimate, worstSingle);
+    CHECK(worstEstimate < 0.6 * worstSingle);
+
+    // turning => the rate is picked up within a second, then no lag
+    double worstTurn = 0;
+    for (int i = 1; i <= 60; i++) {
+        truth = block(300 + 40.0 * i / 20, 30, 1);
+        double err = estimate_error(truth);
+        CHECK(err >= 0);
+        if (i > 20 && err > worstTurn) {
+            worstTurn = err;
+        }
+    }
+    printf("turning 40 deg/s: worst %.2f deg\n", worstTurn);
+    CHECK(worstTurn <= MAX_TURN_ERR_DEG);
+}
+
+/* blocks off 1 g only coast, for at most ORIENT_MAX_COAST of them */
+static void test_coast(void) {
+    double truth = 0;
+
+    initOrient();
+    for (int i = 0; i < 100; i++) {
+        truth = block(45, 30, 1);
+    }
+    CHECK(estimate_error(truth) >= 0 && estimate_error(truth) < 2);
+
+    // vibration => no correction, but the angle doesn't run away
+    for (int i = 1; i < ORIENT_MAX_COAST; i++) {
+        truth = block(45, 30, 1.5);
+        double err = estimate_error(truth);
+        CHECK(err >= 0 && err < 4);
+    }
+    truth = block(45, 30, 1.5);
+    CHECK(estimate_error(truth) < 0);
+    for (int i = 0; i < 10; i++) {
+        truth = block(45, 30, 1.5);
+    }
+    CHECK(estimate_error(truth) < 0);
+
+    // one good block => tracking again from the held angle
+    truth = block(45, 30, 1);
+    CHECK(estimate_error(truth) >= 0 && estimate_error(truth) < 4);
+}
+
+int main(void) {
+    test_heading();
+    test_roll();
+    test_free_fall();
+    test_tracking();
+    test_coast();
+    TEST_END();
+}
@@ -0,0 +1,167 @@
+/**
+ * @file    test_sunpos.c
+ * @author  Mustafa Siddiqui
+ * @brief   Host sweep of the sun position engines in gps.c:
+ *            - str_to_ordinal_date() for every day of 2000-2099
+ *            - calculate_target_angles_fx() against the float
+ *              calculate_target_angles() every minute of a year at the
+ *              latitudes and longitudes quoted in gps.h, checked
+ *              against the error bounds documented there
+ *            - the azimuth main.c steers to, in [0, 360), over a
+ *              summer day at Rochester
+ * @date    10/16/2026
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "test.h"
+#include "../inc/gps.h"
+#include "../inc/fixmath.h"
+//-//
+#include <math.h>   // fabs()
+
+/* bounds documented in gps.h, degrees */
+#define MAX_ZENITH_ERR      0.03
+#define MAX_AZIMUTH_ERR     0.12    //sun 5-90 deg from the zenith
+#define MAX_AZIMUTH_ERR_HI  0.53    //sun 1-5 deg from the zenith
+
+static const int daysInMonth[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+/* every DDMMYY of the century => day of year, leap years included */
+static void test_ordinal_date(void) {
+    char str[16];
+    int wrong = 0;
+
+    for (int year = 2000; year < 2100; year++) {
+        int leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        int doy = 0;
+        for (int month = 1; month <= 12; month++) {
+            int days = daysInMonth[month - 1] + (month == 2 && leap);
+            for (int day = 1; day <= days; day++) {
+                doy++;
+                snprintf(str, sizeof(str), "%02d%02d%02d", day, month, year % 100);
+                wrong += (str_to_ordinal_date(str) != doy);
+            }
+        }
+        CHECK(doy == 365 + leap);
+    }
+    CHECK(wrong == 0);
+
+    //malformed dates are refused
+    CHECK(str_to_ordinal_date("000126") == 0);
+    CHECK(str_to_ordinal_date("011326") == 0);
+    CHECK(str_to_ordinal_date("32012a") == 0);
+}
+
+/* difference of two angles in degrees, wrapped into [-180, 180) */
+static double angle_diff(double a, double b) {
+    double d = fmod(a - b + 540.0, 360.0) - 180.0;
+    return fabs(d);
+}
+
+/* every minute of a year, fixed-point against float */
+static void test_sweep(int year, int days) {
+    static const float lats[] = {-60.0f, -23.44f, 0.0f, 23.44f, 43.16f, 60.0f};
+    static const float lons[] = {-179.9f, -77.6f, 0.0f, 120.0f};
+    //zenith error histogram in 0.01 deg bins
+    long hist[4] = {0, 0, 0, 0};
+    double maxZen = 0, sumZen = 0, maxAz = 0, maxAzHi = 0;
+    long points = 0;
+
+    for (unsigned a = 0; a < sizeof(lats) / sizeof(lats[0]); a++) {
+        for (unsigned o = 0; o < sizeof(lons) / sizeof(lons[0]); o++) {
+            struct TimePos tp = {0};
+            tp.latitude = lats[a];
+            tp.longitude = lons[o];
+            tp.year = (unsigned char)(year - 2000);
+            for (tp.ordinal_date = 1; tp.ordinal_date <= days; tp.ordinal_date++) {
+                for (tp.time = 0; tp.time < 1440; tp.time++) {
+                    float ref[2];
+                    int16_t fx[2];
+                    calculate_target_angles(tp, ref);
+                    calculate_target_angles_fx(tp, fx);
+
+                    double zen = fx[0] * (360.0 / 65536);
+                    double ez = fabs(zen - ref[0]);
+                    double ea = angle_diff(fx[1] * (360.0 / 65536), ref[1]);
+
+                    sumZen += ez;
+                    hist[ez < 0.01 ? 0 : ez < 0.02 ? 1 : ez < 0.03 ? 2 : 3]++;
+                    if (ez > maxZen) {
+                        maxZen = ez;
+                    }
+                    if (ref[0] >= 5.0f && ref[0] <= 90.0f && ea > maxAz) {
+                        maxAz = ea;
+                    } else if (ref[0] >= 1.0f && ref[0] < 5.0f && ea > maxAzHi) {
+                        maxAzHi = ea;
+                    }
+                    points++;
+                }
+            }
+        }
+    }
+
+    printf("%d: %ld points\n", year, points);
+    printf("  zenith  max %.4f mean %.4f deg, <0.01 %.1f%% 0.01-0.02 %.1f%% 0.02-0.03 %.1f%% >0.03 %.1f%%\n",
+           maxZen, sumZen / points, 100.0 * hist[0] / points, 100.0 * hist[1] / points,
+           100.0 * hist[2] / points, 100.0 * hist[3] / points);
+    printf("  azimuth max %.4f deg at 5-90 deg from zenith, %.4f deg at 1-5 deg\n", maxAz, maxAzHi);
+
+    CHECK(maxZen <= MAX_ZENITH_ERR);
+    CHECK(maxAz <= MAX_AZIMUTH_ERR);
+    CHECK(maxAzHi <= MAX_AZIMUTH_ERR_HI);
+}
+
+/*
+ * azimuth in whole degrees as main.c hands it to move_horizontal_to_angle()
+ * => west of south is 180-360, which FX_BAM_TO_DEG() alone makes negative
+ */
+static void test_target_azimuth(void) {
+    struct TimePos tp = {0};
+    int16_t fx[2];
+    float ref[2];
+    int wrong = 0;
+    int afternoon = 0;
+
+    tp.latitude = 43.16f;
+    tp.longitude = -77.6f;
+    tp.year = 26;
+    tp.ordinal_date = 170;
+    for (tp.time = 0; tp.time < 1440; tp.time++) {
+        calculate_target_angles(tp, ref);
+        calculate_target_angles_fx(tp, fx);
+        int az = FX_BAM_TO_DEG360(fx[1]);
+        double want = fmod(ref[1] + 360.0, 360.0);
+
+        wrong += (az < 0 || az >= 360 || angle_diff(az, want) > 0.5 + MAX_AZIMUTH_ERR);
+        // sun high enough to track and west of south => inside the
+        // 90-270 deg range move_horizontal_to_angle() accepts
+        if (ref[0] < 80.0f && want >= 180.0 && want <= 270.0) {
+            afternoon++;
+            wrong += (az < 180 || az > 270);
+        }
+    }
+    CHECK(wrong == 0);
+    CHECK(afternoon > 120);
+
+    //spot checks: solar noon, mid afternoon, evening
+    tp.time = 17*60 + 10;
+    calculate_target_angles_fx(tp, fx);
+    CHECK(abs(FX_BAM_TO_DEG360(fx[1]) - 180) <= 1);
+    tp.time = 18*60;
+    calculate_target_angles_fx(tp, fx);
+    CHECK(FX_BAM_TO_DEG(fx[1]) < 0 && FX_BAM_TO_DEG360(fx[1]) == FX_BAM_TO_DEG(fx[1]) + 360);
+    CHECK(FX_BAM_TO_DEG360(fx[1]) >= 90 && FX_BAM_TO_DEG360(fx[1]) <= 270);
+    tp.time = 23*60;
+    calculate_target_angles_fx(tp, fx);
+    CHECK(FX_BAM_TO_DEG360(fx[1]) > 270);
+}
+
+int main(void) {
+    test_ordinal_date();
+    test_target_azimuth();
+    test_sweep(2026, 365);
+    test_sweep(2028, 366);
+    TEST_END();
+}
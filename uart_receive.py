@@ -7,9 +7,11 @@
 """
 
 import serial
+import sys
 from time import sleep
 
-baud_rate = 9600
+# must match the MCU's link rate, which is raised after the GPS is configured
+baud_rate = int(sys.argv[1]) if len(sys.argv) > 1 else 9600
 
 # create serial object for serial0 pin
 ser = serial.Serial("/dev/ttyS0/", baud_rate)